@@ -0,0 +1,181 @@
+/*
+ *  $Id$
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: SCTPNotificationPool Check
+ *
+ */
+
+
+#include "tdsystem.h"
+#include "sctpnotificationqueue.h"
+#include "sctpnotificationpool.h"
+
+
+
+// ###### Get pool statistics ###############################################
+static SCTPNotificationPool::Statistics getStatistics()
+{
+   SCTPNotificationPool::Statistics statistics;
+   SCTPNotificationQueue::getPool()->getStatistics(statistics);
+   return(statistics);
+}
+
+
+// ###### Fill queue with data arrivals #####################################
+static void addDataArrivals(SCTPNotificationQueue& queue, const cardinal count)
+{
+   for(cardinal i = 0;i < count;i++) {
+      sctp_data_arrive dataArrive;
+      memset((char*)&dataArrive, 0, sizeof(dataArrive));
+      dataArrive.sda_type   = SCTP_DATA_ARRIVE;
+      dataArrive.sda_length = sizeof(dataArrive);
+      dataArrive.sda_ppid   = i;
+      queue.addDataArrive(dataArrive);
+   }
+}
+
+
+// ###### Drop data arrivals, checking their order ##########################
+static bool dropDataArrivals(SCTPNotificationQueue& queue, const cardinal count)
+{
+   bool ordered = true;
+   queue.synchronized();
+   for(cardinal i = 0;i < count;i++) {
+      const SCTPNotificationEntry* entry = queue.getNotification();
+      if((entry == NULL) || (entry->Notification != NULL) ||
+         (entry->DataArrive.sda_ppid != i)) {
+         ordered = false;
+         break;
+      }
+      queue.dropNotification();
+   }
+   queue.unsynchronized();
+   return(ordered);
+}
+
+
+
+// ###### Main program ######################################################
+int main(int argc, char** argv)
+{
+   cardinal rounds = 1000;
+   for(int i = 1;i < argc;i++) {
+      if(!(strncasecmp(argv[i],"-rounds=",8))) {
+         rounds = atol(&argv[i][8]);
+      }
+      else {
+         std::cerr << "Usage: " << argv[0] << " {-rounds=count}" << std::endl;
+         exit(1);
+      }
+   }
+
+   const cardinal poolEntries       = 16;
+   const cardinal poolNotifications = 4;
+   SCTPNotificationPool* pool = SCTPNotificationQueue::getPool();
+   pool->setPoolSize(poolEntries, poolNotifications);
+   SCTPNotificationQueue queue;
+   bool success = true;
+
+
+   // ====== Preallocation ==================================================
+   SCTPNotificationPool::Statistics statistics = getStatistics();
+   const bool preallocated = (statistics.FreeEntries       == poolEntries) &&
+                             (statistics.FreeNotifications == poolNotifications);
+
+
+   // ====== Steady state within pool depth =================================
+   // All entries and notifications must be taken from the pool.
+   SCTPNotificationPool::Statistics before = getStatistics();
+   bool ordered = true;
+   for(cardinal i = 0;i < rounds;i++) {
+      addDataArrivals(queue, poolEntries);
+      if(!dropDataArrivals(queue, poolEntries)) {
+         ordered = false;
+      }
+      SCTPNotification notification;
+      memset((char*)&notification, 0, sizeof(notification));
+      notification.Content.sn_header.sn_type = SCTP_ASSOC_CHANGE;
+      queue.addNotification(notification);
+      queue.dropNotification();
+   }
+   statistics = getStatistics();
+   const card64 entryRequests        = statistics.EntryRequests - before.EntryRequests;
+   const card64 entryAllocations     = statistics.EntryAllocations - before.EntryAllocations;
+   const card64 notificationRequests = statistics.NotificationRequests - before.NotificationRequests;
+   const card64 notificationAllocations =
+      statistics.NotificationAllocations - before.NotificationAllocations;
+
+
+   // ====== Overflow beyond pool depth =====================================
+   // Surplus entries come from the heap and are freed again by flush().
+   before = getStatistics();
+   addDataArrivals(queue, 2 * poolEntries);
+   const card64 overflowAllocations = getStatistics().EntryAllocations - before.EntryAllocations;
+   queue.flush();
+   const cardinal freeAfterFlush = getStatistics().FreeEntries;
+
+
+   // ====== Resize pool ====================================================
+   pool->setPoolSize(2 * poolEntries, 2 * poolNotifications);
+   statistics = getStatistics();
+   const bool grown = (statistics.FreeEntries       == 2 * poolEntries) &&
+                      (statistics.FreeNotifications == 2 * poolNotifications);
+   pool->setPoolSize(poolEntries, poolNotifications);
+   statistics = getStatistics();
+   const bool shrunk = (statistics.FreeEntries       == poolEntries) &&
+                       (statistics.FreeNotifications == poolNotifications);
+   pool->setPoolSize(SCTPNotificationPool::DefaultPoolEntries,
+                     SCTPNotificationPool::DefaultPoolNotifications);
+
+
+   // ====== Check results ==================================================
+   std::cout << "Rounds:                   " << rounds << std::endl
+             << "Preallocated:             " << (preallocated ? "yes" : "NO") << std::endl
+             << "FIFO order:               " << (ordered ? "yes" : "NO") << std::endl
+             << "Entry requests:           " << entryRequests << std::endl
+             << "Entry allocations:        " << entryAllocations << std::endl
+             << "Notification requests:    " << notificationRequests << std::endl
+             << "Notification allocations: " << notificationAllocations << std::endl
+             << "Overflow allocations:     " << overflowAllocations << std::endl
+             << "Free entries after flush: " << freeAfterFlush << std::endl
+             << "Resized:                  " << ((grown && shrunk) ? "yes" : "NO") << std::endl;
+   if((!preallocated) || (!ordered) ||
+      (entryRequests != (card64)rounds * (poolEntries + 1)) || (entryAllocations != 0) ||
+      (notificationRequests != rounds) || (notificationAllocations != 0) ||
+      (overflowAllocations != poolEntries) || (freeAfterFlush != poolEntries) ||
+      (!grown) || (!shrunk)) {
+      std::cerr << "ERROR: SCTPNotificationPool check failed!" << std::endl;
+      success = false;
+   }
+   return((success == true) ? 0 : 1);
+}
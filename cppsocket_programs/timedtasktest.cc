@@ -0,0 +1,266 @@
+/*
+ *  $Id$
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: TimedTask Check
+ *
+ */
+
+
+#include "tdsystem.h"
+#include "timedtask.h"
+#include "tools.h"
+
+
+#include <algorithm>
+#include <vector>
+
+
+
+/**
+  * Log of the check, storing the order of the timer events.
+  */
+class CheckLog : public Synchronizable
+{
+   public:
+   CheckLog();
+
+   std::vector<cardinal> Order;
+   cardinal              EarlyEvents;
+};
+
+
+// ###### Constructor #######################################################
+CheckLog::CheckLog()
+   : Synchronizable("CheckLog")
+{
+   EarlyEvents = 0;
+}
+
+
+
+/**
+  * Task of the check, recording its timer events.
+  */
+class CheckTask : public TimedTask
+{
+   public:
+   CheckTask(CheckLog* log = NULL, const cardinal id = 0);
+   ~CheckTask();
+
+   inline cardinal getCalls();
+
+   card64 Due;
+
+   protected:
+   void timerEvent();
+
+   private:
+   CheckLog* Log;
+   cardinal  ID;
+   cardinal  Calls;
+};
+
+
+// ###### Constructor #######################################################
+CheckTask::CheckTask(CheckLog* log, const cardinal id)
+   : TimedTask(0, "CheckTask")
+{
+   Due   = 0;
+   Log   = log;
+   ID    = id;
+   Calls = 0;
+}
+
+
+// ###### Destructor ########################################################
+CheckTask::~CheckTask()
+{
+   stop();
+}
+
+
+// ###### Get number of timer events ########################################
+inline cardinal CheckTask::getCalls()
+{
+   synchronized();
+   const cardinal calls = Calls;
+   unsynchronized();
+   return(calls);
+}
+
+
+// ###### Timer event #######################################################
+void CheckTask::timerEvent()
+{
+   const card64 now = getMicroTime();
+   synchronized();
+   Calls++;
+   unsynchronized();
+   if(Log != NULL) {
+      Log->synchronized();
+      if(now < Due) {
+         Log->EarlyEvents++;
+      }
+      Log->Order.push_back(ID);
+      Log->unsynchronized();
+   }
+}
+
+
+
+// ###### Main program ######################################################
+int main(int argc, char** argv)
+{
+   cardinal tasks = 100;
+   for(int i = 1;i < argc;i++) {
+      if(!(strncasecmp(argv[i],"-tasks=",7))) {
+         tasks = atol(&argv[i][7]);
+      }
+      else {
+         std::cerr << "Usage: " << argv[0] << " {-tasks=count}" << std::endl;
+         exit(1);
+      }
+   }
+   if(tasks < 4) {
+      tasks = 4;
+   }
+
+
+   // ====== Single-shot tasks in random order ==============================
+   // All tasks share one dispatcher thread. Their due times are 5ms apart,
+   // so that the events have to be dispatched in the order of their due
+   // times, regardless of the order the tasks have been scheduled in.
+   TimedTaskDispatcher::setPoolSize(1);
+   CheckLog log;
+   std::vector<CheckTask*> taskArray(tasks);
+   std::vector<cardinal>   slots(tasks);
+   for(cardinal i = 0;i < tasks;i++) {
+      taskArray[i] = new CheckTask(&log, i);
+      slots[i]     = i;
+   }
+   std::random_shuffle(slots.begin(), slots.end());
+   const card64 start = getMicroTime() + 500000;
+   for(cardinal i = 0;i < tasks;i++) {
+      CheckTask* task = taskArray[slots[i]];
+      task->Due = start + (5000 * (card64)slots[i]);
+      task->start();
+      task->setNextActionAbs(task->Due);
+   }
+
+   // ====== Cancel every fourth task before it is due ======================
+   cardinal cancelled = 0;
+   for(cardinal i = 0;i < tasks;i += 4) {
+      taskArray[i]->stop();
+      cancelled++;
+   }
+   Thread::delay(600000 + (5000 * (card64)tasks));
+
+
+   // ====== Periodic task with call limit ==================================
+   CheckTask limitedTask;
+   limitedTask.start();
+   limitedTask.setNextAction(10000, 5);
+
+
+   // ====== Periodic tasks on a pool of dispatcher threads =================
+   TimedTaskDispatcher::setPoolSize(4);
+   CheckTask periodicTasks[8];
+   for(cardinal i = 0;i < 8;i++) {
+      periodicTasks[i].setInterval(10000);
+      periodicTasks[i].start();
+   }
+   Thread::delay(1000000);
+   cardinal periodicCalls[8];
+   for(cardinal i = 0;i < 8;i++) {
+      periodicTasks[i].stop();
+      periodicCalls[i] = periodicTasks[i].getCalls();
+   }
+   const cardinal dispatchers = TimedTaskDispatcher::getPoolSize();
+   Thread::delay(100000);
+
+
+   // ====== Check results ==================================================
+   bool     success     = true;
+   cardinal missed      = 0;
+   cardinal wrong       = 0;
+   cardinal minPeriodic = ~0;
+   cardinal maxPeriodic = 0;
+   cardinal afterStop   = 0;
+   for(cardinal i = 0;i < tasks;i++) {
+      const cardinal calls = taskArray[i]->getCalls();
+      if((i % 4) == 0) {
+         if(calls != 0) {
+            wrong++;
+         }
+      }
+      else if(calls != 1) {
+         missed++;
+      }
+      delete taskArray[i];
+   }
+   log.synchronized();
+   const cardinal events     = log.Order.size();
+   cardinal       outOfOrder = 0;
+   for(cardinal i = 1;i < events;i++) {
+      if(log.Order[i] < log.Order[i - 1]) {
+         outOfOrder++;
+      }
+   }
+   const cardinal earlyEvents = log.EarlyEvents;
+   log.unsynchronized();
+   for(cardinal i = 0;i < 8;i++) {
+      minPeriodic = std::min(minPeriodic, periodicCalls[i]);
+      maxPeriodic = std::max(maxPeriodic, periodicCalls[i]);
+      if(periodicTasks[i].getCalls() != periodicCalls[i]) {
+         afterStop++;
+      }
+   }
+   std::cout << "Tasks:             " << tasks << " (" << cancelled << " cancelled)" << std::endl
+             << "Events:            " << events << std::endl
+             << "Early events:      " << earlyEvents << std::endl
+             << "Out of order:      " << outOfOrder << std::endl
+             << "Missed tasks:      " << missed << std::endl
+             << "Cancelled fired:   " << wrong << std::endl
+             << "Limited task:      " << limitedTask.getCalls() << " event(s) at call limit 5" << std::endl
+             << "Periodic tasks:    " << minPeriodic << "-" << maxPeriodic
+                                      << " event(s) in 1s at 10ms interval, "
+                                      << dispatchers << " dispatcher(s)" << std::endl
+             << "Events after stop: " << afterStop << std::endl;
+   if((earlyEvents != 0) || (outOfOrder != 0) || (missed != 0) || (wrong != 0) ||
+      (events != tasks - cancelled) || (limitedTask.getCalls() != 5) ||
+      (minPeriodic < 90) || (maxPeriodic > 102) || (afterStop != 0)) {
+      std::cerr << "ERROR: TimedTask check failed!" << std::endl;
+      success = false;
+   }
+   return((success == true) ? 0 : 1);
+}
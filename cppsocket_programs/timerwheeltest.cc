@@ -0,0 +1,220 @@
+/*
+ *  $Id$
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: TimerWheelThread Check
+ *
+ */
+
+
+#include "tdsystem.h"
+#include "timerwheelthread.h"
+#include "tools.h"
+
+
+#include <vector>
+
+
+
+/**
+  * Timer of the check, storing its expected expiry time.
+  */
+class CheckTimer : public TimerWheelThread::Timer
+{
+   public:
+   CheckTimer();
+
+   card64   Due;
+   card64   Interval;
+   bool     Cancelled;
+   cardinal Fired;
+};
+
+
+// ###### Constructor #######################################################
+CheckTimer::CheckTimer()
+{
+   Due       = 0;
+   Interval  = 0;
+   Cancelled = false;
+   Fired     = 0;
+}
+
+
+
+/**
+  * Timer wheel thread of the check, recording early and late timer events.
+  */
+class CheckWheel : public TimerWheelThread
+{
+   public:
+   CheckWheel();
+
+   cardinal Events;
+   cardinal EarlyEvents;
+   card64   MaxLateness;
+
+   protected:
+   void timerEvent(Timer* timer);
+};
+
+
+// ###### Constructor #######################################################
+CheckWheel::CheckWheel()
+   : TimerWheelThread(100, "CheckWheel")
+{
+   Events      = 0;
+   EarlyEvents = 0;
+   MaxLateness = 0;
+}
+
+
+// ###### Timer event #######################################################
+void CheckWheel::timerEvent(Timer* timer)
+{
+   CheckTimer*  checkTimer = (CheckTimer*)timer;
+   const card64 now        = getMicroTime();
+   // Periodic timers are only counted, since missed periods are skipped.
+   if(checkTimer->Interval == 0) {
+      if(now < checkTimer->Due) {
+         EarlyEvents++;
+      }
+      else if(now - checkTimer->Due > MaxLateness) {
+         MaxLateness = now - checkTimer->Due;
+      }
+   }
+   checkTimer->Fired++;
+   Events++;
+}
+
+
+
+// ###### Main program ######################################################
+int main(int argc, char** argv)
+{
+   cardinal timers = 20000;
+   for(int i = 1;i < argc;i++) {
+      if(!(strncasecmp(argv[i],"-timers=",8))) {
+         timers = atol(&argv[i][8]);
+      }
+      else {
+         std::cerr << "Usage: " << argv[0] << " {-timers=count}" << std::endl;
+         exit(1);
+      }
+   }
+   if(timers < 4) {
+      timers = 4;
+   }
+
+
+   // ====== Start random timers, then cancel and rearm some of them ========
+   // All timers are due after more than 1s, so that cancelling and rearming
+   // is finished before the first event.
+   CheckWheel wheel;
+   wheel.start();
+
+   std::vector<CheckTimer> timerArray(timers);
+   card64 now = getMicroTime();
+   for(cardinal i = 0;i < timers;i++) {
+      timerArray[i].Due = now + 1000000 + (random() % 1000000);
+      wheel.startTimerAbs(&timerArray[i], timerArray[i].Due);
+   }
+   cardinal cancelled = 0;
+   for(cardinal i = 0;i < timers;i += 4) {
+      if(wheel.stopTimer(&timerArray[i])) {
+         timerArray[i].Cancelled = true;
+         cancelled++;
+      }
+   }
+   now = getMicroTime();
+   for(cardinal i = 1;i < timers;i += 4) {
+      timerArray[i].Due = now + 1000000 + (random() % 500000);
+      wheel.startTimerAbs(&timerArray[i], timerArray[i].Due);
+   }
+
+   // ====== Timer beyond the first wheel level =============================
+   CheckTimer longTimer;
+   longTimer.Due = getMicroTime() + 2500000;
+   wheel.startTimerAbs(&longTimer, longTimer.Due);
+
+   // ====== Timer beyond the wheel range ===================================
+   CheckTimer farTimer;
+   farTimer.Due = getMicroTime() + (100ULL * 24 * 3600 * 1000000);
+   wheel.startTimerAbs(&farTimer, farTimer.Due);
+
+   Thread::delay(3000000);
+
+
+   // ====== Periodic timer =================================================
+   CheckTimer periodicTimer;
+   const cardinal before = wheel.Events;
+   periodicTimer.Interval = 500;
+   periodicTimer.Due      = getMicroTime() + 500;
+   wheel.startTimerAbs(&periodicTimer, periodicTimer.Due, periodicTimer.Interval);
+   Thread::delay(1000000);
+   wheel.stopTimer(&periodicTimer);
+   const cardinal periodicEvents = wheel.Events - before;
+
+   const cardinal running = wheel.getTimers();
+   wheel.stop();
+
+
+   // ====== Check results ==================================================
+   bool     success = true;
+   cardinal missed  = 0;
+   cardinal wrong   = 0;
+   for(cardinal i = 0;i < timers;i++) {
+      if(timerArray[i].Cancelled) {
+         if(timerArray[i].Fired != 0) {
+            wrong++;
+         }
+      }
+      else if(timerArray[i].Fired != 1) {
+         missed++;
+      }
+   }
+   std::cout << "Timers:          " << timers << " (" << cancelled << " cancelled)" << std::endl
+             << "Early events:    " << wheel.EarlyEvents << std::endl
+             << "Max. lateness:   " << wheel.MaxLateness << " us" << std::endl
+             << "Missed timers:   " << missed << std::endl
+             << "Cancelled fired: " << wrong << std::endl
+             << "Long timer:      " << longTimer.Fired << " event(s)" << std::endl
+             << "Periodic timer:  " << periodicEvents << " event(s) in 1s at 500us interval" << std::endl
+             << "Still running:   " << running << std::endl;
+   if((wheel.EarlyEvents != 0) || (missed != 0) || (wrong != 0) ||
+      (longTimer.Fired != 1) || (farTimer.Fired != 0) ||
+      (periodicEvents < 1000) || (periodicEvents > 2001) || (running != 1)) {
+      std::cerr << "ERROR: TimerWheelThread check failed!" << std::endl;
+      success = false;
+   }
+   return((success == true) ? 0 : 1);
+}
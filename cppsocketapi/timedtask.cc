@@ -0,0 +1,265 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Timed Task Implementation
+ *
+ */
+
+
+#include "tdsystem.h"
+#include "timedtask.h"
+#include "tools.h"
+
+
+
+// ###### Constructor #######################################################
+TimedTask::TimedTask(const card64 usec,
+                     const char*  name)
+   : Synchronizable(name)
+{
+   Dispatcher          = NULL;
+   Interval            = 0;
+   CallLimit           = 0;
+   Calls               = 0;
+   Next                = 0;
+   Generation          = 0;
+   TimerCorrection     = 10;
+   FastStart           = true;
+   Active              = false;
+   LeaveCorrectionLoop = false;
+   setParameters(usec,0);
+}
+
+
+// ###### Destructor ########################################################
+TimedTask::~TimedTask()
+{
+   stop();
+}
+
+
+// ###### Start task ########################################################
+bool TimedTask::start()
+{
+   synchronized();
+   if(Dispatcher == NULL) {
+      Dispatcher = TimedTaskDispatcher::attachTask();
+      if(Dispatcher == NULL) {
+#ifndef DISABLE_WARNINGS
+         std::cerr << "ERROR: TimedTask::start() - No dispatcher thread available!" << std::endl;
+#endif
+         unsynchronized();
+         return(false);
+      }
+      update();
+   }
+   unsynchronized();
+   return(true);
+}
+
+
+// ###### Stop task #########################################################
+void TimedTask::stop()
+{
+   synchronized();
+   TimedTaskDispatcher* dispatcher = Dispatcher;
+   Dispatcher = NULL;
+   Generation++;
+   unsynchronized();
+
+   if(dispatcher != NULL) {
+      // A dispatch() call, which is already running, sees Dispatcher == NULL
+      // and does not rearm the timer. Wait until it has finished.
+      dispatcher->stopTimer(this);
+      dispatcher->waitForTimerEvent(this);
+      TimedTaskDispatcher::detachTask(dispatcher);
+   }
+}
+
+
+// ###### Set new interval ##################################################
+void TimedTask::setInterval(const card64 usec)
+{
+   synchronized();
+   setParameters(usec,0);
+   unsynchronized();
+}
+
+
+// ###### Set time to next invokation #######################################
+void TimedTask::setNextAction(const card64 usec,
+                              const card64 callLimit)
+{
+   synchronized();
+   FastStart = false;
+   setParameters(usec,callLimit);
+   unsynchronized();
+}
+
+
+// ###### Set time to next invokation #######################################
+void TimedTask::setNextActionAbs(const card64 timeStamp,
+                                 const card64 callLimit)
+{
+   const card64 now = getMicroTime();
+   synchronized();
+   FastStart = false;
+   if((int64)timeStamp - (int64)now > 0) {
+      setParameters(timeStamp - now,callLimit);
+   }
+   else {
+      setParameters(1,callLimit);
+   }
+   unsynchronized();
+}
+
+
+// ###### Set timer correction mode #########################################
+void TimedTask::setTimerCorrection(const cardinal maxCorrection)
+{
+   synchronized();
+   TimerCorrection = maxCorrection;
+   update();
+   unsynchronized();
+}
+
+
+// ###### Set fast start mode ###############################################
+void TimedTask::setFastStart(const bool on)
+{
+   synchronized();
+   FastStart = on;
+   update();
+   unsynchronized();
+}
+
+
+// ###### Set parameters ####################################################
+void TimedTask::setParameters(const card64 usec, const card64 callLimit)
+{
+   LeaveCorrectionLoop = false;
+   Interval            = usec;
+   CallLimit           = callLimit;
+   Active              = (usec > 0);
+   update();
+}
+
+
+// ###### Schedule next invokation after parameter update ###################
+// Same as the parameter update of MultiTimerThread::run(): the call count
+// is reset and the first invokation is scheduled according to FastStart.
+void TimedTask::update()
+{
+   Generation++;
+   Calls = 0;
+   if(Dispatcher == NULL) {
+      return;
+   }
+   if(Active) {
+      const card64 now = getMicroTime();
+      if(FastStart == false) {
+         if((Interval != 0) && (CallLimit == 0)) {
+            Next = now + (Dispatcher->random32() % Interval);
+         }
+         else {
+            Next = now + Interval;
+         }
+      }
+      else {
+         Next = now;
+      }
+      Dispatcher->startTimerAbs(this,Next);
+   }
+   else {
+      Dispatcher->stopTimer(this);
+   }
+}
+
+
+// ###### Invoke timerEvent(), called by dispatcher thread ##################
+void TimedTask::dispatch()
+{
+   synchronized();
+   if((Dispatcher == NULL) || (!Active)) {
+      unsynchronized();
+      return;
+   }
+
+   // ====== Invoke timer event =============================================
+   const cardinal generation = Generation;
+   card64 now = getMicroTime();
+   Next += Interval;
+   Calls++;
+   unsynchronized();
+   timerEvent();
+   synchronized();
+
+   // ====== Do timer correction ============================================
+   // The timer is not rearmed, if the task has been stopped or its
+   // parameters have been updated by timerEvent() or another thread.
+   if(Generation == generation) {
+      if((CallLimit > 0) && (Calls >= CallLimit)) {
+         Active = false;
+      }
+      else if(now >= Next) {
+         if(now < Next + (TimerCorrection * Interval)) {
+            while(Next < now) {
+               if(LeaveCorrectionLoop) {
+                  LeaveCorrectionLoop = false;
+                  break;
+               }
+               Next += Interval;
+               Calls++;
+               unsynchronized();
+               timerEvent();
+               synchronized();
+               if(Generation != generation) {
+                  break;
+               }
+
+               now = getMicroTime();
+               if((CallLimit > 0) && (Calls >= CallLimit)) {
+                  Active = false;
+                  break;
+               }
+            }
+         }
+         else {
+            Next = getMicroTime() + Interval;
+         }
+      }
+      if((Generation == generation) && (Active)) {
+         Dispatcher->startTimerAbs(this,Next);
+      }
+   }
+   unsynchronized();
+}
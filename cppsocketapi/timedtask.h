@@ -0,0 +1,230 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Timed Task Implementation
+ *
+ */
+
+
+#ifndef TIMEDTASK_H
+#define TIMEDTASK_H
+
+
+#include "tdsystem.h"
+#include "synchronizable.h"
+#include "timedtaskdispatcher.h"
+
+
+
+/**
+  * This abstract class realizes a periodic task with the interface and
+  * timer semantics of TimedThread. In contrast to TimedThread, it does not
+  * have its own thread: after start(), its timerEvent() calls are made by
+  * a thread of the shared TimedTaskDispatcher pool. This is useful for
+  * processes with many, mostly sleeping periodic tasks (e.g. one keepalive
+  * timer per peer). The user of this class has to implement timerEvent().
+  * Since the dispatcher threads are shared, timerEvent() should not block.
+  *
+  * A subclass has to call stop() in its destructor, since the dispatcher
+  * may otherwise invoke timerEvent() during destruction.
+  *
+  * @short   Timed Task
+  * @author  Thomas Dreibholz (thomas.dreibholz@gmail.com)
+  * @version 1.0
+  * @see TimedThread
+  * @see TimedTaskDispatcher
+  */
+class TimedTask : public TimerWheelThread::Timer,
+                  public Synchronizable
+{
+   friend class TimedTaskDispatcher;
+
+   // ====== Constructor/Destructor =========================================
+   public:
+   /**
+     * Constructor. A new timed task with a given interval will be created
+     * but *not* started! To start the task, call start(). See TimedThread
+     * for details on the interval, timer correction and fast start
+     * settings.
+     *
+     * @param usec Interval in microseconds.
+     * @param name Task name.
+     *
+     * @see start
+     * @see timerEvent
+     * @see TimedThread#TimedThread
+     */
+   TimedTask(const card64 usec,
+             const char*  name = "TimedTask");
+
+   /**
+     * Destructor.
+     */
+   virtual ~TimedTask();
+
+
+   // ====== Start/stop =====================================================
+   /**
+     * Start task, i.e. attach it to a dispatcher thread of the pool.
+     *
+     * @return true, if task has been started; false otherwise.
+     */
+   bool start();
+
+   /**
+     * Stop task. When this method returns, the task's timerEvent() is
+     * not running any more (unless stop() is called by timerEvent() itself).
+     */
+   void stop();
+
+   /**
+     * Check, if task is started.
+     *
+     * @return true, if task is started; false otherwise.
+     */
+   inline bool running();
+
+
+   // ====== Interval functions =============================================
+   /**
+     * Get timed task's interval.
+     *
+     * @return Interval in microseconds.
+     */
+   inline card64 getInterval();
+
+   /**
+     * Set timed task's interval.
+     *
+     * @param usec Interval in microseconds (0 to deactivate timer).
+     */
+   void setInterval(const card64 usec);
+
+   /**
+     * Like setInterval(), but disabling FastStart first. This method
+     * can be used e.g. for a single shot timer.
+     *
+     * @param usec Time to next invokation.
+     * @param callLimit Call count limit (0 for infinite, default: 1).
+     *
+     * @see setInterval
+     */
+   void setNextAction(const card64 usec      = 0,
+                      const card64 callLimit = 1);
+
+   /**
+     * Like setNextAction(), but the time stamp of the next invokation
+     * is given as absolute time (microseconds since January 01, 1970).
+     *
+     * @param timeStamp Time stamp of next invokation.
+     * @param callLimit Call count limit (0 for infinite, default: 1).
+     *
+     * @see setInterval
+     * @see setNextAction
+     */
+   void setNextActionAbs(const card64 timeStamp = 0,
+                         const card64 callLimit = 1);
+
+   /**
+     * Get maxCorrection value for inaccurate system timer.
+     *
+     * @return Maximum number of correction calls.
+     *
+     * @see setTimerCorrection
+     */
+   inline cardinal getTimerCorrection();
+
+   /**
+     * Set correction of inaccurate system timer to given value.
+     * See TimedThread::setTimerCorrection() for details.
+     *
+     * @param maxCorrection Maximum number of correction calls (0 to turn correction off).
+     */
+   void setTimerCorrection(const cardinal maxCorrection = 0);
+
+   /**
+     * Leave timer correction loop: If the task is in a timer correction
+     * loop, the loop will be finished after the current timerEvent() call
+     * returns.
+     */
+   inline void leaveCorrectionLoop();
+
+   /**
+     * Set fast start option: If false, the first call of timerEvent() will
+     * be made *after* the given interval; otherwise it will be made immediately.
+     * The default is true.
+     *
+     * @param on true, to set option; false otherwise.
+     */
+   void setFastStart(const bool on);
+
+   /**
+     * Get fast start option.
+     *
+     * @return true, if option is set; false otherwise.
+     */
+   inline bool getFastStart();
+
+
+   // ====== timerEvent() to be implemented by subclass =====================
+   protected:
+   /**
+     * The virtual timerEvent() method, which contains the timed task's
+     * implementation. It has to be implemented by classes, which inherit
+     * TimedTask. This method is called regularly with the given interval.
+     */
+   virtual void timerEvent() = 0;
+
+
+   // ====== Private data ===================================================
+   private:
+   void setParameters(const card64 usec, const card64 callLimit);
+   void update();
+   void dispatch();
+
+   TimedTaskDispatcher* Dispatcher;
+   card64               Interval;
+   card64               CallLimit;
+   card64               Calls;
+   card64               Next;
+   cardinal             Generation;
+   cardinal             TimerCorrection;
+   bool                 FastStart;
+   bool                 Active;
+   bool                 LeaveCorrectionLoop;
+};
+
+
+#include "timedtask.icc"
+
+
+#endif
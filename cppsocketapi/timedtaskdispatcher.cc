@@ -0,0 +1,146 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Timed Task Dispatcher Implementation
+ *
+ */
+
+
+#include "tdsystem.h"
+#include "timedtaskdispatcher.h"
+#include "timedtask.h"
+
+
+
+// ###### TimedTaskDispatcher static attributes #############################
+Synchronizable       TimedTaskDispatcher::PoolLock("TimedTaskDispatcher::PoolLock");
+TimedTaskDispatcher* TimedTaskDispatcher::Pool[TimedTaskDispatcher::MaxPoolSize];
+cardinal             TimedTaskDispatcher::PoolThreads = 0;
+cardinal             TimedTaskDispatcher::PoolSize    = 1;
+
+
+
+// ###### Constructor #######################################################
+TimedTaskDispatcher::TimedTaskDispatcher(const char* name)
+   : TimerWheelThread(100, name)
+{
+   Tasks = 0;
+}
+
+
+// ###### Destructor ########################################################
+TimedTaskDispatcher::~TimedTaskDispatcher()
+{
+   stop();
+}
+
+
+// ###### Set pool size #####################################################
+void TimedTaskDispatcher::setPoolSize(const cardinal threads)
+{
+   PoolLock.synchronized();
+   PoolSize = (threads < 1) ? 1 : ((threads > MaxPoolSize) ? MaxPoolSize : threads);
+   PoolLock.unsynchronized();
+}
+
+
+// ###### Get pool size #####################################################
+cardinal TimedTaskDispatcher::getPoolSize()
+{
+   PoolLock.synchronized();
+   const cardinal poolSize = PoolSize;
+   PoolLock.unsynchronized();
+   return(poolSize);
+}
+
+
+// ###### Get dispatcher for new task #######################################
+TimedTaskDispatcher* TimedTaskDispatcher::attachTask()
+{
+   PoolLock.synchronized();
+
+   // ====== Create new dispatcher thread, if pool is not yet complete ======
+   if(PoolThreads < PoolSize) {
+      TimedTaskDispatcher* dispatcher = new TimedTaskDispatcher();
+      if(dispatcher != NULL) {
+         if(dispatcher->start()) {
+            Pool[PoolThreads++] = dispatcher;
+         }
+         else {
+#ifndef DISABLE_WARNINGS
+            std::cerr << "WARNING: TimedTaskDispatcher::attachTask() - Unable to start dispatcher thread!" << std::endl;
+#endif
+            delete dispatcher;
+         }
+      }
+   }
+
+   // ====== Choose dispatcher with lowest number of tasks ==================
+   TimedTaskDispatcher* dispatcher = NULL;
+   for(cardinal i = 0;i < PoolThreads;i++) {
+      if((dispatcher == NULL) || (Pool[i]->Tasks < dispatcher->Tasks)) {
+         dispatcher = Pool[i];
+      }
+   }
+   if(dispatcher != NULL) {
+      dispatcher->Tasks++;
+   }
+
+   PoolLock.unsynchronized();
+   return(dispatcher);
+}
+
+
+// ###### Release dispatcher of task ########################################
+void TimedTaskDispatcher::detachTask(TimedTaskDispatcher* dispatcher)
+{
+   PoolLock.synchronized();
+   dispatcher->Tasks--;
+   PoolLock.unsynchronized();
+}
+
+
+// ###### Get random number #################################################
+card32 TimedTaskDispatcher::random32()
+{
+   synchronized();
+   const card32 number = Random.random32();
+   unsynchronized();
+   return(number);
+}
+
+
+// ###### The TimerWheelThread's timerEvent() implementation ################
+void TimedTaskDispatcher::timerEvent(Timer* timer)
+{
+   static_cast<TimedTask*>(timer)->dispatch();
+}
@@ -0,0 +1,125 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Timed Task Dispatcher Implementation
+ *
+ */
+
+
+#ifndef TIMEDTASKDISPATCHER_H
+#define TIMEDTASKDISPATCHER_H
+
+
+#include "tdsystem.h"
+#include "timerwheelthread.h"
+#include "randomizer.h"
+
+
+class TimedTask;
+
+
+
+/**
+  * This class realizes a dispatcher thread for TimedTask objects, based on
+  * TimerWheelThread. Instead of one thread per task, the tasks of a process
+  * share a pool of dispatcher threads; a task is assigned to the dispatcher
+  * with the lowest number of tasks when it is started. Since a dispatcher
+  * invokes the timerEvent() calls of its tasks one after another, these
+  * calls should not block.
+  *
+  * @short   Timed Task Dispatcher
+  * @author  Thomas Dreibholz (thomas.dreibholz@gmail.com)
+  * @version 1.0
+  * @see TimedTask
+  * @see TimerWheelThread
+  */
+class TimedTaskDispatcher : public TimerWheelThread
+{
+   friend class TimedTask;
+
+   // ====== Constructor/Destructor =========================================
+   public:
+   /**
+     * Constructor. The dispatcher thread is *not* started!
+     *
+     * @param name Thread name.
+     */
+   TimedTaskDispatcher(const char* name = "TimedTaskDispatcher");
+
+   /**
+     * Destructor.
+     */
+   ~TimedTaskDispatcher();
+
+
+   // ====== Dispatcher pool ================================================
+   /**
+     * Set number of dispatcher threads of the shared pool. The threads are
+     * created on demand; the pool never shrinks.
+     *
+     * @param threads Number of threads (1 to MaxPoolSize).
+     */
+   static void setPoolSize(const cardinal threads);
+
+   /**
+     * Get number of dispatcher threads of the shared pool.
+     *
+     * @return Number of threads.
+     */
+   static cardinal getPoolSize();
+
+   /**
+     * Maximum number of dispatcher threads.
+     */
+   static const cardinal MaxPoolSize = 64;
+
+
+   // ====== Private data ===================================================
+   protected:
+   void timerEvent(Timer* timer);
+
+   private:
+   static TimedTaskDispatcher* attachTask();
+   static void detachTask(TimedTaskDispatcher* dispatcher);
+   card32 random32();
+
+   Randomizer                  Random;
+   cardinal                    Tasks;
+
+   static Synchronizable       PoolLock;
+   static TimedTaskDispatcher* Pool[MaxPoolSize];
+   static cardinal             PoolThreads;
+   static cardinal             PoolSize;
+};
+
+
+#endif
@@ -0,0 +1,423 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Timer Wheel Thread Implementation
+ *
+ */
+
+
+#include "tdsystem.h"
+#include "timerwheelthread.h"
+#include "tools.h"
+
+
+
+// ###### Timer constructor #################################################
+TimerWheelThread::Timer::Timer()
+{
+   Owner      = NULL;
+   Prev       = NULL;
+   Next       = NULL;
+   Head       = NULL;
+   Expiry     = 0;
+   ExpiryTick = 0;
+   Interval   = 0;
+}
+
+
+// ###### Timer destructor ##################################################
+TimerWheelThread::Timer::~Timer()
+{
+   if(Owner != NULL) {
+      Owner->stopTimer(this);
+   }
+}
+
+
+// ###### Constructor #######################################################
+TimerWheelThread::TimerWheelThread(const card64   resolution,
+                                   const char*    name,
+                                   const cardinal flags)
+   : Thread(name,flags),
+     WakeUp("TimerWheelThread::WakeUp"),
+     EventFinished("TimerWheelThread::EventFinished"),
+     Resolution((resolution > 0) ? resolution : 1),
+     StartTime(getMicroTime())
+{
+   NextTick       = 0;
+   NextWakeupTick = (card64)-1;
+   Running        = 0;
+   Shutdown       = false;
+   Pending        = NULL;
+   Current        = NULL;
+   for(cardinal i = 0;i < Levels;i++) {
+      Occupied[i] = 0;
+      for(cardinal j = 0;j < Slots;j++) {
+         Wheel[i][j] = NULL;
+      }
+   }
+}
+
+
+// ###### Destructor ########################################################
+TimerWheelThread::~TimerWheelThread()
+{
+   synchronized();
+   while(Pending != NULL) {
+      Timer* timer = Pending;
+      unlink(timer);
+      timer->Owner = NULL;
+   }
+   for(cardinal i = 0;i < Levels;i++) {
+      for(cardinal j = 0;j < Slots;j++) {
+         while(Wheel[i][j] != NULL) {
+            Timer* timer = Wheel[i][j];
+            unlink(timer);
+            timer->Owner = NULL;
+         }
+      }
+   }
+   Running = 0;
+   unsynchronized();
+}
+
+
+// ###### Reimplementation of cancel() ######################################
+void TimerWheelThread::cancel()
+{
+   synchronized();
+   Shutdown = true;
+   unsynchronized();
+   WakeUp.signal();
+}
+
+
+// ###### Reimplementation of stop() ########################################
+void* TimerWheelThread::stop()
+{
+   cancel();
+   join();
+   return(NULL);
+}
+
+
+// ###### Start or rearm timer at given time stamp ##########################
+void TimerWheelThread::startTimerAbs(Timer*       timer,
+                                     const card64 timeStamp,
+                                     const card64 interval)
+{
+   synchronized();
+   if(timer->Owner == this) {
+      unlink(timer);
+   }
+   else if(timer->Owner != NULL) {
+#ifndef DISABLE_WARNINGS
+      std::cerr << "ERROR: TimerWheelThread::startTimerAbs() - Timer is running in another TimerWheelThread!" << std::endl;
+#endif
+      unsynchronized();
+      return;
+   }
+   else {
+      timer->Owner = this;
+      Running++;
+   }
+
+   // ====== Round expiry up to next tick ===================================
+   timer->Expiry     = timeStamp;
+   timer->Interval   = interval;
+   timer->ExpiryTick = getTick(timeStamp);
+   if(StartTime + (timer->ExpiryTick * Resolution) < timeStamp) {
+      timer->ExpiryTick++;
+   }
+   link(timer);
+
+   // ====== Wake up thread, if the timer is due before its wakeup ==========
+   const bool wakeUp = (timer->ExpiryTick < NextWakeupTick);
+   if(wakeUp) {
+      NextWakeupTick = timer->ExpiryTick;
+   }
+   unsynchronized();
+
+   if(wakeUp) {
+      WakeUp.signal();
+   }
+}
+
+
+// ###### Stop timer ########################################################
+bool TimerWheelThread::stopTimer(Timer* timer)
+{
+   synchronized();
+   if(timer->Owner != this) {
+      unsynchronized();
+      return(false);
+   }
+   unlink(timer);
+   timer->Owner = NULL;
+   Running--;
+   unsynchronized();
+   return(true);
+}
+
+
+// ###### Wait for running timer event ######################################
+void TimerWheelThread::waitForTimerEvent(const Timer* timer)
+{
+   if((PThread != 0) && (pthread_equal(pthread_self(), PThread))) {
+      return;
+   }
+   synchronized();
+   while(Current == timer) {
+      unsynchronized();
+      // The Fired state of EventFinished may also have been consumed by
+      // another waiter. Therefore, Current is checked again periodically.
+      EventFinished.timedWait(10000);
+      synchronized();
+   }
+   unsynchronized();
+}
+
+
+// ###### Insert timer into wheel ###########################################
+// Like the classic Linux timer wheel: a timer due within Slots^(l+1) ticks
+// is stored in level l, at the slot given by the expiry tick's l-th digit.
+// It is moved to a lower level (cascaded) when the wheel reaches the
+// beginning of that slot.
+void TimerWheelThread::link(Timer* timer)
+{
+   card64 tick = std::max(timer->ExpiryTick, NextTick);
+   if(tick - NextTick >= ((card64)1 << (SlotBits * Levels))) {
+      // Beyond range of wheel -> clamp; the timer is inserted again
+      // when its slot is cascaded.
+      tick = NextTick + ((card64)1 << (SlotBits * Levels)) - 1;
+   }
+
+   cardinal level = 0;
+   while((level < Levels - 1) &&
+         (tick - NextTick >= ((card64)1 << (SlotBits * (level + 1))))) {
+      level++;
+   }
+   const cardinal slot = (cardinal)(tick >> (SlotBits * level)) & SlotMask;
+
+   timer->Head = &Wheel[level][slot];
+   timer->Prev = NULL;
+   timer->Next = Wheel[level][slot];
+   if(timer->Next != NULL) {
+      timer->Next->Prev = timer;
+   }
+   Wheel[level][slot] = timer;
+   Occupied[level] |= ((card64)1 << slot);
+}
+
+
+// ###### Remove timer from its list ########################################
+void TimerWheelThread::unlink(Timer* timer)
+{
+   if(timer->Next != NULL) {
+      timer->Next->Prev = timer->Prev;
+   }
+   if(timer->Prev != NULL) {
+      timer->Prev->Next = timer->Next;
+   }
+   else {
+      *(timer->Head) = timer->Next;
+      if((timer->Next == NULL) && (timer->Head != &Pending)) {
+         const cardinal index = (cardinal)(timer->Head - &Wheel[0][0]);
+         Occupied[index / Slots] &= ~((card64)1 << (index % Slots));
+      }
+   }
+   timer->Prev = NULL;
+   timer->Next = NULL;
+   timer->Head = NULL;
+}
+
+
+// ###### Move timers of a slot to lower levels #############################
+void TimerWheelThread::cascade(const cardinal level, const cardinal slot)
+{
+   Timer* timer = Wheel[level][slot];
+   Wheel[level][slot] = NULL;
+   Occupied[level] &= ~((card64)1 << slot);
+   while(timer != NULL) {
+      Timer* next = timer->Next;
+      link(timer);
+      timer = next;
+   }
+}
+
+
+// ###### Get next tick requiring work ######################################
+// Returns the next tick at which a level 0 slot is due or a slot of a
+// higher level has to be cascaded; (card64)-1, if there are no timers.
+card64 TimerWheelThread::getNextEventTick() const
+{
+   card64 next = (card64)-1;
+   for(cardinal level = 0;level < Levels;level++) {
+      if(Occupied[level] == 0) {
+         continue;
+      }
+      const cardinal shift  = SlotBits * level;
+      const card64   window = (card64)1 << (shift + SlotBits);
+      const card64   base   = NextTick & ~(window - 1);
+      const cardinal index  = (cardinal)(NextTick >> shift) & SlotMask;
+
+      // The current slot of a higher level has already been cascaded,
+      // unless the wheel is at its very beginning.
+      const bool     atSlotStart = ((NextTick & (((card64)1 << shift) - 1)) == 0);
+      const cardinal first       = ((level == 0) || (atSlotStart)) ? index : index + 1;
+      const card64   candidates  = (first < Slots) ? (Occupied[level] & ((card64)-1 << first)) : 0;
+
+      card64 tick;
+      if(candidates != 0) {
+         tick = base + ((card64)__builtin_ctzll(candidates) << shift);
+      }
+      else {
+         // All occupied slots belong to the next rotation.
+         tick = base + window + ((card64)__builtin_ctzll(Occupied[level]) << shift);
+      }
+      next = std::min(next, tick);
+   }
+   return(next);
+}
+
+
+// ###### Process all ticks up to given tick ################################
+void TimerWheelThread::advance(const card64 tick)
+{
+   while((NextTick <= tick) && (!Shutdown)) {
+      // ====== Skip ticks without work =====================================
+      const card64 eventTick = getNextEventTick();
+      if(eventTick > tick) {
+         NextTick = tick + 1;
+         break;
+      }
+      NextTick = eventTick;
+
+      // ====== Cascade higher levels =======================================
+      const cardinal index = (cardinal)NextTick & SlotMask;
+      if(index == 0) {
+         for(cardinal level = 1;level < Levels;level++) {
+            const cardinal slot = (cardinal)(NextTick >> (SlotBits * level)) & SlotMask;
+            cascade(level, slot);
+            if(slot != 0) {
+               break;
+            }
+         }
+      }
+
+      // ====== Move due timers to pending list =============================
+      Timer* timer = Wheel[0][index];
+      Wheel[0][index] = NULL;
+      Occupied[0] &= ~((card64)1 << index);
+      const card64 currentTick = NextTick;
+      NextTick++;
+      while(timer != NULL) {
+         Timer* next = timer->Next;
+         if(timer->ExpiryTick <= currentTick) {
+            timer->Head = &Pending;
+            timer->Prev = NULL;
+            timer->Next = Pending;
+            if(Pending != NULL) {
+               Pending->Prev = timer;
+            }
+            Pending = timer;
+         }
+         else {
+            link(timer);   // Clamped timer beyond range of wheel
+         }
+         timer = next;
+      }
+
+      // ====== Invoke timer events =========================================
+      // The lock is released for timerEvent(), so the pending list may be
+      // modified by startTimer() and stopTimer() meanwhile.
+      while((Pending != NULL) && (!Shutdown)) {
+         timer = Pending;
+         unlink(timer);
+         if(timer->Interval > 0) {
+            const card64 now = getMicroTime();
+            timer->Expiry += timer->Interval;
+            if(timer->Expiry < now) {
+               timer->Expiry = now + timer->Interval;
+            }
+            timer->ExpiryTick = getTick(timer->Expiry);
+            if(StartTime + (timer->ExpiryTick * Resolution) < timer->Expiry) {
+               timer->ExpiryTick++;
+            }
+            link(timer);
+         }
+         else {
+            timer->Owner = NULL;
+            Running--;
+         }
+         Current = timer;
+         unsynchronized();
+         timerEvent(timer);
+         synchronized();
+         Current = NULL;
+         EventFinished.broadcast();
+      }
+   }
+}
+
+
+// ###### The thread's run() implementation #################################
+void TimerWheelThread::run()
+{
+   synchronized();
+   while(!Shutdown) {
+      // ====== Handle expired timers =======================================
+      advance(getTick(getMicroTime()));
+      if(Shutdown) {
+         break;
+      }
+
+      // ====== Wait for next timer or for timer updates ====================
+      NextWakeupTick = getNextEventTick();
+      const card64 wakeupTick = NextWakeupTick;
+      unsynchronized();
+
+      if(wakeupTick == (card64)-1) {
+         WakeUp.wait();
+      }
+      else {
+         const card64 wakeupTime = StartTime + (wakeupTick * Resolution);
+         const card64 now        = getMicroTime();
+         if(wakeupTime > now) {
+            WakeUp.timedWait(wakeupTime - now);
+         }
+      }
+
+      synchronized();
+   }
+   unsynchronized();
+}
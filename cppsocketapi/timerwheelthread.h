@@ -0,0 +1,252 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Timer Wheel Thread Implementation
+ *
+ */
+
+
+#ifndef TIMERWHEELTHREAD_H
+#define TIMERWHEELTHREAD_H
+
+
+#include "tdsystem.h"
+#include "thread.h"
+#include "condition.h"
+
+
+
+/**
+  * This abstract class realizes a timer thread for an arbitrary number of
+  * timers, based on Thread. In contrast to MultiTimerThread, timers are
+  * objects (see TimerWheelThread::Timer) which may be added, cancelled and
+  * rearmed at runtime in constant time. The timers are kept in a
+  * hierarchical timing wheel of Levels levels with Slots slots each; the
+  * thread sleeps until the next non-empty slot. The user of this class has
+  * to implement timerEvent().
+  *
+  * Missed periods of periodic timers are not replayed: if the thread falls
+  * behind by more than one interval, the next expiry is one interval after
+  * the current time.
+  *
+  * @short   Timer Wheel Thread
+  * @author  Thomas Dreibholz (thomas.dreibholz@gmail.com)
+  * @version 1.0
+  * @see Thread
+  * @see MultiTimerThread
+  */
+class TimerWheelThread : public Thread
+{
+   // ====== Timer ==========================================================
+   public:
+   /**
+     * A timer of a TimerWheelThread. To attach application data, inherit
+     * from this class. A timer must not be destroyed while its timerEvent()
+     * call is running in the timer thread, unless it is destroyed by this
+     * call itself. A running timer is stopped by the destructor.
+     */
+   class Timer
+   {
+      friend class TimerWheelThread;
+
+      public:
+      /**
+        * Constructor.
+        */
+      Timer();
+
+      /**
+        * Destructor.
+        */
+      ~Timer();
+
+      private:
+      TimerWheelThread* Owner;      // NULL, if timer is not running
+      Timer*            Prev;
+      Timer*            Next;
+      Timer**           Head;       // List head of slot or pending list
+      card64            Expiry;     // Absolute time in microseconds
+      card64            ExpiryTick;
+      card64            Interval;   // 0 for single-shot timer
+   };
+
+
+   // ====== Constructor/Destructor =========================================
+   /**
+     * Constructor. A new timer wheel thread will be created but *not*
+     * started! To start the new thread, call start().
+     *
+     * @param resolution Tick length of the timing wheel in microseconds.
+     * @param name Thread name.
+     * @param flags Thread flags.
+     *
+     * @see Thread#start
+     * @see timerEvent
+     */
+   TimerWheelThread(const card64   resolution = 100,
+                    const char*    name       = "TimerWheelThread",
+                    const cardinal flags      = TF_CancelDeferred);
+
+   /**
+     * Destructor. All timers are stopped.
+     */
+   ~TimerWheelThread();
+
+
+   // ====== Timer functions ================================================
+   /**
+     * Start or rearm timer.
+     *
+     * @param timer Timer.
+     * @param usec Time to first invokation in microseconds (0 = immediately).
+     * @param interval Interval for periodic timer in microseconds (0 for single shot timer).
+     */
+   inline void startTimer(Timer*       timer,
+                          const card64 usec,
+                          const card64 interval = 0);
+
+   /**
+     * Like startTimer(), but the time stamp of the first invokation
+     * is given as absolute time (microseconds since January 01, 1970).
+     *
+     * @param timer Timer.
+     * @param timeStamp Time stamp of first invokation.
+     * @param interval Interval for periodic timer in microseconds (0 for single shot timer).
+     *
+     * @see startTimer
+     */
+   void startTimerAbs(Timer*       timer,
+                      const card64 timeStamp,
+                      const card64 interval = 0);
+
+   /**
+     * Stop timer.
+     *
+     * @param timer Timer.
+     * @return true, if timer has been running; false otherwise.
+     */
+   bool stopTimer(Timer* timer);
+
+   /**
+     * Wait until a timerEvent() call for the given timer, which is running
+     * in the timer thread, has returned. When called by the timer thread
+     * itself, this method returns immediately. Use stopTimer() and then
+     * waitForTimerEvent() before destroying a timer in another thread.
+     *
+     * @param timer Timer.
+     */
+   void waitForTimerEvent(const Timer* timer);
+
+   /**
+     * Check, if timer is running.
+     *
+     * @param timer Timer.
+     * @return true, if timer is running; false otherwise.
+     */
+   inline bool isTimerRunning(const Timer* timer);
+
+   /**
+     * Get number of running timers.
+     *
+     * @return Number of running timers.
+     */
+   inline cardinal getTimers();
+
+   /**
+     * Get tick length of the timing wheel.
+     *
+     * @return Resolution in microseconds.
+     */
+   inline card64 getResolution() const;
+
+   /**
+     * Reimplementation of Thread's cancel() method.
+     *
+     * @see Thread#cancel
+     */
+   void cancel();
+
+   /**
+     * Reimplementation of Thread's stop() method.
+     *
+     * @see Thread#stop
+     */
+   void* stop();
+
+
+   // ====== timerEvent() to be implemented by subclass =====================
+   protected:
+   /**
+     * The virtual timerEvent() method, which is called by the timer thread
+     * when a timer expires. It has to be implemented by classes, which
+     * inherit TimerWheelThread. The TimerWheelThread lock is not held, so
+     * timers may be started or stopped here.
+     *
+     * @param timer Expired timer.
+     */
+   virtual void timerEvent(Timer* timer) = 0;
+
+
+   // ====== Private data ===================================================
+   private:
+   void run();
+   inline card64 getTick(const card64 timeStamp) const;
+   void link(Timer* timer);
+   void unlink(Timer* timer);
+   void cascade(const cardinal level, const cardinal slot);
+   void advance(const card64 tick);
+   card64 getNextEventTick() const;
+
+   static const cardinal SlotBits = 6;
+   static const cardinal Slots    = (1 << SlotBits);
+   static const cardinal SlotMask = Slots - 1;
+   static const cardinal Levels   = 6;
+
+   Condition           WakeUp;
+   Condition           EventFinished;
+   const card64        Resolution;
+   const card64        StartTime;
+   card64              NextTick;
+   card64              NextWakeupTick;
+   cardinal            Running;
+   bool                Shutdown;
+   card64              Occupied[Levels];
+   Timer*              Wheel[Levels][Slots];
+   Timer*              Pending;
+   Timer*              Current;
+};
+
+
+#include "timerwheelthread.icc"
+
+
+#endif
@@ -0,0 +1,189 @@
+/*
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2003 by Michael Tuexen
+ * Copyright (C) 2003-2026 by Thomas Dreibholz
+ *
+ * $Id$
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ */
+
+/*
+ * Accept rate benchmark: measures the rate of connect()/accept()/close()
+ * cycles on the loopback interface, depending on the number of other
+ * descriptors being open in the process.
+ */
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/time.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef LINUX
+#include <getopt.h>
+#endif
+#include <ext_socket.h>
+
+
+const char* Usage = "\
+Usage: acceptbench\n\
+Options:\n\
+        -p      local port\n\
+        -n      maximum number of additionally opened descriptors\n\
+        -s      step size for the number of opened descriptors\n\
+        -c      number of accepts per measurement\n\
+";
+
+#define DEFAULT_PORT        5002
+#define DEFAULT_MAXIMUM     16384
+#define DEFAULT_STEP        2048
+#define DEFAULT_CYCLES      256
+
+
+static double measure(int listenfd, struct sockaddr_in* addr, unsigned int cycles)
+{
+   struct timeval start_time, now;
+   unsigned int   i;
+   int            fd, afd;
+
+   gettimeofday(&start_time, NULL);
+   for (i = 0; i < cycles; i++) {
+      if ((fd = ext_socket(AF_INET, SOCK_STREAM, IPPROTO_SCTP)) < 0) {
+         perror("socket");
+         exit(1);
+      }
+      if (ext_connect(fd, (struct sockaddr *)addr, sizeof(struct sockaddr_in)) < 0) {
+         perror("connect");
+         exit(1);
+      }
+      if ((afd = ext_accept(listenfd, NULL, NULL)) < 0) {
+         perror("accept");
+         exit(1);
+      }
+      ext_close(afd);
+      ext_close(fd);
+   }
+   gettimeofday(&now, NULL);
+   return((now.tv_sec - start_time.tv_sec) + (double)(now.tv_usec - start_time.tv_usec) / 1000000);
+}
+
+
+int main(int argc, char **argv)
+{
+   struct sockaddr_in addr;
+   unsigned int       maximum, step, cycles, opened, i;
+   int                listenfd, c;
+   int*               ballast;
+   short              port;
+   double             seconds;
+   const int          on = 1;
+
+   port    = DEFAULT_PORT;
+   maximum = DEFAULT_MAXIMUM;
+   step    = DEFAULT_STEP;
+   cycles  = DEFAULT_CYCLES;
+
+   while ((c = getopt(argc, argv, "p:n:s:c:")) != -1) {
+      switch(c) {
+         case 'p':
+            port = atoi(optarg);
+          break;
+         case 'n':
+            maximum = atoi(optarg);
+          break;
+         case 's':
+            step = atoi(optarg);
+          break;
+         case 'c':
+            cycles = atoi(optarg);
+          break;
+         default:
+            fputs(Usage, stderr);
+            exit(1);
+          break;
+      }
+   }
+   if ((step == 0) || (cycles == 0)) {
+      fputs(Usage, stderr);
+      exit(1);
+   }
+
+   memset((void *) &addr, 0, sizeof(addr));
+   addr.sin_family      = AF_INET;
+#ifdef HAVE_SIN_LEN
+   addr.sin_len         = sizeof(struct sockaddr_in);
+#endif
+   addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+   addr.sin_port        = htons(port);
+
+   if ((listenfd = ext_socket(AF_INET, SOCK_STREAM, IPPROTO_SCTP)) < 0) {
+      perror("socket");
+      exit(1);
+   }
+   ext_setsockopt(listenfd, SOL_SOCKET, SO_REUSEADDR, (const void*)&on, (socklen_t)sizeof(on));
+   if (ext_bind(listenfd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+      perror("bind");
+      exit(1);
+   }
+   if (ext_listen(listenfd, 16) < 0) {
+      perror("listen");
+      exit(1);
+   }
+
+   /* Unconnected SCTP sockets only occupy descriptor table slots. */
+   ballast = (int*)malloc(sizeof(int) * (maximum + 1));
+   opened  = 0;
+   fprintf(stdout, "Descriptors, Accepts/s\n");
+   for (;;) {
+      seconds = measure(listenfd, &addr, cycles);
+      fprintf(stdout, "%u, %f\n", opened, cycles / seconds);
+      fflush(stdout);
+      if (opened >= maximum) {
+         break;
+      }
+      for (i = 0; (i < step) && (opened < maximum); i++) {
+         if ((ballast[opened] = ext_socket(AF_INET, SOCK_STREAM, IPPROTO_SCTP)) < 0) {
+            perror("socket");
+            maximum = opened;
+            break;
+         }
+         opened++;
+      }
+   }
+
+   for (i = 0; i < opened; i++) {
+      ext_close(ballast[i]);
+   }
+   free(ballast);
+   ext_close(listenfd);
+   return 0;
+}
@@ -0,0 +1,211 @@
+/*
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2003 by Michael Tuexen
+ * Copyright (C) 2003-2026 by Thomas Dreibholz
+ *
+ * $Id$
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ */
+
+/*
+ * Eager receive check: the receiver's eager receive ring is too small for
+ * all messages sent while it does not read. Large messages therefore
+ * remain in sctplib, while smaller messages sent after them would still
+ * fit into the ring. All messages have to be received completely and in
+ * the original order.
+ */
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef LINUX
+#include <getopt.h>
+#endif
+#include <ext_socket.h>
+
+
+const char* Usage = "\
+Usage: eagertest\n\
+Options:\n\
+        -p      local port\n\
+        -r      size of receive ring in bytes\n\
+        -n      number of large/small message pairs\n\
+";
+
+#define DEFAULT_PORT        5003
+#define DEFAULT_RING_SIZE   4096
+#define DEFAULT_PAIRS       8
+#define LARGE_MESSAGE_SIZE  3000
+#define SMALL_MESSAGE_SIZE  100
+#define BUFFER_SIZE         65536
+
+
+static unsigned int messageSize(unsigned int number)
+{
+   return((number % 2) ? SMALL_MESSAGE_SIZE : LARGE_MESSAGE_SIZE);
+}
+
+
+int main(int argc, char **argv)
+{
+   struct sockaddr_in addr;
+   struct msghdr      msg;
+   struct iovec       iov;
+   unsigned int       ringSize, pairs, messages, number, size, i;
+   unsigned int       header[2];
+   int                listenfd, sendfd, recvfd, c, received, errors;
+   char               buffer[BUFFER_SIZE];
+   short              port;
+   const int          on = 1;
+
+   port     = DEFAULT_PORT;
+   ringSize = DEFAULT_RING_SIZE;
+   pairs    = DEFAULT_PAIRS;
+
+   while ((c = getopt(argc, argv, "p:r:n:")) != -1) {
+      switch(c) {
+         case 'p':
+            port = atoi(optarg);
+          break;
+         case 'r':
+            ringSize = atoi(optarg);
+          break;
+         case 'n':
+            pairs = atoi(optarg);
+          break;
+         default:
+            fputs(Usage, stderr);
+            exit(1);
+          break;
+      }
+   }
+   messages = 2 * pairs;
+
+   memset((void *) &addr, 0, sizeof(addr));
+   addr.sin_family      = AF_INET;
+#ifdef HAVE_SIN_LEN
+   addr.sin_len         = sizeof(struct sockaddr_in);
+#endif
+   addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+   addr.sin_port        = htons(port);
+
+   if ((listenfd = ext_socket(AF_INET, SOCK_STREAM, IPPROTO_SCTP)) < 0) {
+      perror("socket");
+      exit(1);
+   }
+   ext_setsockopt(listenfd, SOL_SOCKET, SO_REUSEADDR, (const void*)&on, (socklen_t)sizeof(on));
+   if (ext_setsockopt(listenfd, IPPROTO_SCTP, SCTP_EAGER_RECEIVE, (const void*)&ringSize, (socklen_t)sizeof(ringSize)) < 0) {
+      perror("setsockopt SCTP_EAGER_RECEIVE");
+      exit(1);
+   }
+   if (ext_bind(listenfd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+      perror("bind");
+      exit(1);
+   }
+   if (ext_listen(listenfd, 1) < 0) {
+      perror("listen");
+      exit(1);
+   }
+   if ((sendfd = ext_socket(AF_INET, SOCK_STREAM, IPPROTO_SCTP)) < 0) {
+      perror("socket");
+      exit(1);
+   }
+   if (ext_connect(sendfd, (struct sockaddr *)&addr, sizeof(struct sockaddr_in)) < 0) {
+      perror("connect");
+      exit(1);
+   }
+   if ((recvfd = ext_accept(listenfd, NULL, NULL)) < 0) {
+      perror("accept");
+      exit(1);
+   }
+
+   /* Each message starts with its number and size, followed by a fill
+      pattern derived from the number. */
+   for (number = 0; number < messages; number++) {
+      size = messageSize(number);
+      header[0] = number;
+      header[1] = size;
+      memset(buffer, (int)(number & 0xff), size);
+      memcpy(buffer, header, sizeof(header));
+      if (ext_send(sendfd, buffer, size, 0) != (ssize_t)size) {
+         perror("send");
+         exit(1);
+      }
+   }
+
+   /* Let all messages arrive before reading the first one. */
+   sleep(1);
+
+   errors = 0;
+   for (number = 0; number < messages; number++) {
+      iov.iov_base = buffer;
+      iov.iov_len  = sizeof(buffer);
+      memset(&msg, 0, sizeof(msg));
+      msg.msg_iov    = &iov;
+      msg.msg_iovlen = 1;
+      received = ext_recvmsg(recvfd, &msg, 0);
+      if (received < 0) {
+         perror("recvmsg");
+         exit(1);
+      }
+      size = messageSize(number);
+      memcpy(header, buffer, sizeof(header));
+      if ((received != (int)size) || (!(msg.msg_flags & MSG_EOR)) ||
+          (header[0] != number) || (header[1] != size)) {
+         fprintf(stderr, "Message #%u: expected %u bytes, got %d bytes of message #%u (%u bytes)%s\n",
+                 number, size, received, header[0], header[1],
+                 (msg.msg_flags & MSG_EOR) ? "" : " without MSG_EOR");
+         errors++;
+         continue;
+      }
+      for (i = sizeof(header); i < size; i++) {
+         if (buffer[i] != (char)(number & 0xff)) {
+            fprintf(stderr, "Message #%u: corrupted at byte %u\n", number, i);
+            errors++;
+            break;
+         }
+      }
+   }
+
+   ext_close(recvfd);
+   ext_close(sendfd);
+   ext_close(listenfd);
+
+   if (errors > 0) {
+      fprintf(stdout, "FAILED: %d of %u messages wrong\n", errors, messages);
+      return 1;
+   }
+   fprintf(stdout, "OK: %u messages received in order\n", messages);
+   return 0;
+}
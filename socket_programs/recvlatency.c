@@ -0,0 +1,202 @@
+/*
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2003 by Michael Tuexen
+ * Copyright (C) 2003-2026 by Thomas Dreibholz
+ *
+ * $Id$
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ */
+
+/*
+ * Receive wakeup latency benchmark: a thread is blocked in ext_recv() on
+ * one end of a loopback association. The main thread sends a message
+ * containing its send time; the receiving thread measures the time until
+ * it has been woken up and has received the message.
+ */
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/time.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef LINUX
+#include <getopt.h>
+#endif
+#include <ext_socket.h>
+
+
+const char* Usage = "\
+Usage: recvlatency\n\
+Options:\n\
+        -p      local port\n\
+        -n      number of messages\n\
+        -g      gap between messages in microseconds\n\
+";
+
+#define DEFAULT_PORT        5004
+#define DEFAULT_MESSAGES    1000
+#define DEFAULT_GAP         10000
+
+
+static int          recvfd;
+static unsigned int messages;
+
+
+static double getTime(void)
+{
+   struct timeval now;
+   gettimeofday(&now, NULL);
+   return(now.tv_sec + (double)now.tv_usec / 1000000);
+}
+
+
+static void* receiver(void* arg)
+{
+   double       sent, latency, minimum, maximum, sum;
+   unsigned int i;
+
+   minimum = 1e9;
+   maximum = 0.0;
+   sum     = 0.0;
+   for (i = 0; i < messages; i++) {
+      if (ext_recv(recvfd, (void*)&sent, sizeof(sent), 0) != (ssize_t)sizeof(sent)) {
+         perror("recv");
+         exit(1);
+      }
+      latency = getTime() - sent;
+      if (latency < minimum) {
+         minimum = latency;
+      }
+      if (latency > maximum) {
+         maximum = latency;
+      }
+      sum += latency;
+   }
+   fprintf(stdout, "Messages: %u\n", messages);
+   fprintf(stdout, "Latency:  min %.1f us, avg %.1f us, max %.1f us\n",
+           1000000.0 * minimum, 1000000.0 * sum / messages, 1000000.0 * maximum);
+   return(NULL);
+}
+
+
+int main(int argc, char **argv)
+{
+   struct sockaddr_in addr;
+   pthread_t          thread;
+   unsigned int       gap, i;
+   int                listenfd, sendfd, c;
+   double             now;
+   short              port;
+   const int          on = 1;
+
+   port     = DEFAULT_PORT;
+   messages = DEFAULT_MESSAGES;
+   gap      = DEFAULT_GAP;
+
+   while ((c = getopt(argc, argv, "p:n:g:")) != -1) {
+      switch(c) {
+         case 'p':
+            port = atoi(optarg);
+          break;
+         case 'n':
+            messages = atoi(optarg);
+          break;
+         case 'g':
+            gap = atoi(optarg);
+          break;
+         default:
+            fputs(Usage, stderr);
+            exit(1);
+          break;
+      }
+   }
+   if (messages == 0) {
+      fputs(Usage, stderr);
+      exit(1);
+   }
+
+   memset((void *) &addr, 0, sizeof(addr));
+   addr.sin_family      = AF_INET;
+#ifdef HAVE_SIN_LEN
+   addr.sin_len         = sizeof(struct sockaddr_in);
+#endif
+   addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+   addr.sin_port        = htons(port);
+
+   if ((listenfd = ext_socket(AF_INET, SOCK_STREAM, IPPROTO_SCTP)) < 0) {
+      perror("socket");
+      exit(1);
+   }
+   ext_setsockopt(listenfd, SOL_SOCKET, SO_REUSEADDR, (const void*)&on, (socklen_t)sizeof(on));
+   if (ext_bind(listenfd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+      perror("bind");
+      exit(1);
+   }
+   if (ext_listen(listenfd, 1) < 0) {
+      perror("listen");
+      exit(1);
+   }
+   if ((sendfd = ext_socket(AF_INET, SOCK_STREAM, IPPROTO_SCTP)) < 0) {
+      perror("socket");
+      exit(1);
+   }
+   if (ext_connect(sendfd, (struct sockaddr *)&addr, sizeof(struct sockaddr_in)) < 0) {
+      perror("connect");
+      exit(1);
+   }
+   if ((recvfd = ext_accept(listenfd, NULL, NULL)) < 0) {
+      perror("accept");
+      exit(1);
+   }
+
+   if (pthread_create(&thread, NULL, receiver, NULL) != 0) {
+      perror("pthread_create");
+      exit(1);
+   }
+   for (i = 0; i < messages; i++) {
+      /* Give the receiver time to block in ext_recv() again. */
+      usleep(gap);
+      now = getTime();
+      if (ext_send(sendfd, (const void*)&now, sizeof(now), 0) != (ssize_t)sizeof(now)) {
+         perror("send");
+         exit(1);
+      }
+   }
+   pthread_join(thread, NULL);
+
+   ext_close(recvfd);
+   ext_close(sendfd);
+   ext_close(listenfd);
+   return 0;
+}
@@ -0,0 +1,224 @@
+/*
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2003 by Michael Tuexen
+ * Copyright (C) 2003-2026 by Thomas Dreibholz
+ *
+ * $Id$
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ */
+
+/*
+ * Multi-iovec send benchmark: the main thread sends messages consisting of
+ * several iovecs with ext_sendmsg() over a loopback association, while a
+ * receiving thread drains the other end. The send rate is measured.
+ */
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/time.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef LINUX
+#include <getopt.h>
+#endif
+#include <ext_socket.h>
+
+
+const char* Usage = "\
+Usage: sendbench\n\
+Options:\n\
+        -p      local port\n\
+        -n      number of messages\n\
+        -i      number of iovecs per message\n\
+        -s      size of each iovec in bytes\n\
+";
+
+#define DEFAULT_PORT        5005
+#define DEFAULT_MESSAGES    100000
+#define DEFAULT_IOVECS      4
+#define DEFAULT_IOVEC_SIZE  256
+#define MAX_IOVECS          64
+
+
+static int          recvfd;
+static unsigned int messages;
+static size_t       messageSize;
+
+
+static double getTime(void)
+{
+   struct timeval now;
+   gettimeofday(&now, NULL);
+   return(now.tv_sec + (double)now.tv_usec / 1000000);
+}
+
+
+static void* receiver(void* arg)
+{
+   char*        buffer;
+   unsigned int i;
+
+   if ((buffer = malloc(messageSize)) == NULL) {
+      perror("malloc");
+      exit(1);
+   }
+   for (i = 0; i < messages; i++) {
+      if (ext_recv(recvfd, (void*)buffer, messageSize, 0) != (ssize_t)messageSize) {
+         perror("recv");
+         exit(1);
+      }
+   }
+   free(buffer);
+   return(NULL);
+}
+
+
+int main(int argc, char **argv)
+{
+   struct sockaddr_in addr;
+   struct iovec       iov[MAX_IOVECS];
+   struct msghdr      msg;
+   pthread_t          thread;
+   unsigned int       iovecs, i;
+   size_t             iovecSize;
+   char*              buffer;
+   int                listenfd, sendfd, c;
+   double             start, duration;
+   short              port;
+   const int          on = 1;
+
+   port      = DEFAULT_PORT;
+   messages  = DEFAULT_MESSAGES;
+   iovecs    = DEFAULT_IOVECS;
+   iovecSize = DEFAULT_IOVEC_SIZE;
+
+   while ((c = getopt(argc, argv, "p:n:i:s:")) != -1) {
+      switch(c) {
+         case 'p':
+            port = atoi(optarg);
+          break;
+         case 'n':
+            messages = atoi(optarg);
+          break;
+         case 'i':
+            iovecs = atoi(optarg);
+          break;
+         case 's':
+            iovecSize = atoi(optarg);
+          break;
+         default:
+            fputs(Usage, stderr);
+            exit(1);
+          break;
+      }
+   }
+   if ((messages == 0) || (iovecs == 0) || (iovecs > MAX_IOVECS) || (iovecSize == 0)) {
+      fputs(Usage, stderr);
+      exit(1);
+   }
+   messageSize = iovecs * iovecSize;
+
+   if ((buffer = malloc(messageSize)) == NULL) {
+      perror("malloc");
+      exit(1);
+   }
+   memset(buffer, 'A', messageSize);
+   for (i = 0; i < iovecs; i++) {
+      iov[i].iov_base = &buffer[i * iovecSize];
+      iov[i].iov_len  = iovecSize;
+   }
+   memset((void *) &msg, 0, sizeof(msg));
+   msg.msg_iov    = iov;
+   msg.msg_iovlen = iovecs;
+
+   memset((void *) &addr, 0, sizeof(addr));
+   addr.sin_family      = AF_INET;
+#ifdef HAVE_SIN_LEN
+   addr.sin_len         = sizeof(struct sockaddr_in);
+#endif
+   addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+   addr.sin_port        = htons(port);
+
+   if ((listenfd = ext_socket(AF_INET, SOCK_STREAM, IPPROTO_SCTP)) < 0) {
+      perror("socket");
+      exit(1);
+   }
+   ext_setsockopt(listenfd, SOL_SOCKET, SO_REUSEADDR, (const void*)&on, (socklen_t)sizeof(on));
+   if (ext_bind(listenfd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+      perror("bind");
+      exit(1);
+   }
+   if (ext_listen(listenfd, 1) < 0) {
+      perror("listen");
+      exit(1);
+   }
+   if ((sendfd = ext_socket(AF_INET, SOCK_STREAM, IPPROTO_SCTP)) < 0) {
+      perror("socket");
+      exit(1);
+   }
+   if (ext_connect(sendfd, (struct sockaddr *)&addr, sizeof(struct sockaddr_in)) < 0) {
+      perror("connect");
+      exit(1);
+   }
+   if ((recvfd = ext_accept(listenfd, NULL, NULL)) < 0) {
+      perror("accept");
+      exit(1);
+   }
+
+   if (pthread_create(&thread, NULL, receiver, NULL) != 0) {
+      perror("pthread_create");
+      exit(1);
+   }
+   start = getTime();
+   for (i = 0; i < messages; i++) {
+      if (ext_sendmsg(sendfd, &msg, 0) != (ssize_t)messageSize) {
+         perror("sendmsg");
+         exit(1);
+      }
+   }
+   duration = getTime() - start;
+   pthread_join(thread, NULL);
+
+   fprintf(stdout, "Messages: %u of %u iovecs with %u bytes each\n",
+           messages, iovecs, (unsigned int)iovecSize);
+   fprintf(stdout, "Sending:  %.3f s, %.0f messages/s, %.1f us/message\n",
+           duration, messages / duration, 1000000.0 * duration / messages);
+
+   ext_close(recvfd);
+   ext_close(sendfd);
+   ext_close(listenfd);
+   free(buffer);
+   return 0;
+}
@@ -37,169 +37,20 @@
 
 #include "tdsystem.h"
 #include "condition.h"
-#include "thread.h"
-
-#include <sys/time.h>
-
-
-// #define PRINT_SIGNAL
 
 
 
 // ###### Constructor #######################################################
-Condition::Condition(const char* name,
-                     Condition*  parentCondition,
-                     const bool  recursive)
-   : Synchronizable(name,recursive)
+Condition::Condition(const char*    name,
+                     LeanCondition* parentCondition,
+                     const bool     recursive)
+   : Synchronizable(name,recursive),
+     LeanCondition(parentCondition)
 {
-   Valid = true;
-   addParent(parentCondition);
-   pthread_cond_init(&ConditionVariable,NULL);
-   Fired = false;
 }
 
 
 // ###### Destructor ########################################################
 Condition::~Condition()
 {
-   Valid = false;
-   if(pthread_cond_destroy(&ConditionVariable) != 0) {
-#ifndef DISABLE_WARNINGS
-      std::cerr << "ERROR: Condition::~Condition() - "
-                   "Another thread is still waiting for this condition!" << std::endl;
-      std::cerr << "Condition name is \"" << MutexName << "\"." << std::endl;
-      abort();
-#endif
-   }
-}
-
-
-// ###### Add parent condition ##############################################
-void Condition::addParent(Condition* parentCondition)
-{
-   if(parentCondition != NULL) {
-      synchronized();
-      ParentSet.insert(parentCondition);
-      if(Fired) {
-         parentCondition->broadcast();
-      }
-      unsynchronized();
-   }
-}
-
-
-// ###### Remove parent condition ###########################################
-void Condition::removeParent(Condition* parentCondition)
-{
-   if(parentCondition != NULL) {
-      synchronized();
-      ParentSet.erase(parentCondition);
-      unsynchronized();
-   }
-}
-
-
-// ###### Wait for condition ################################################
-void Condition::wait()
-{
-   while(!timedWait(3600000000ULL)) {
-      sched_yield();
-   }
-}
-
-
-// ###### Fire condition ####################################################
-void Condition::signal()
-{
-   synchronized();
-   Fired = true;
-   pthread_cond_signal(&ConditionVariable);
-
-#ifdef PRINT_SIGNAL
-   std::cout << "signal: " << getName() << std::endl;
-#endif
-
-   std::set<Condition*>::iterator iterator = ParentSet.begin();
-   while(iterator != ParentSet.end()) {
-      (*iterator)->signal();
-      iterator++;
-   }
-
-   unsynchronized();
-}
-
-
-// ###### Broadcast condition ###############################################
-void Condition::broadcast()
-{
-   synchronized();
-   Fired = true;
-
-   pthread_cond_broadcast(&ConditionVariable);
-
-#ifdef PRINT_SIGNAL
-   std::cout << "broadcast: " << getName() << std::endl;
-#endif
-
-   std::set<Condition*>::iterator iterator = ParentSet.begin();
-   while(iterator != ParentSet.end()) {
-      (*iterator)->broadcast();
-      iterator++;
-   }
-
-   unsynchronized();
-}
-
-
-// ###### Wait for condition with timeout ###################################
-bool Condition::timedWait(const card64 microseconds)
-{
-   cardinal oldstate = Thread::setCancelState(Thread::TCS_CancelDisabled);
-   synchronized();
-
-   // ====== Initialize timeout settings ====================================
-   timeval  now;
-   timespec timeout;
-   gettimeofday(&now,NULL);
-   timeout.tv_sec  = now.tv_sec + (long)(microseconds / 1000000);
-   timeout.tv_nsec = (now.tv_usec + (long)(microseconds % 1000000)) * 1000;
-   if(timeout.tv_nsec >= 1000000000) {
-      timeout.tv_sec++;
-      timeout.tv_nsec -= 1000000000;
-   }
-
-   // ====== Wait ===========================================================
-   int result = EINTR;
-   if(Fired) {
-      result = 0;
-   }
-   else {
-      result = pthread_cond_timedwait(&ConditionVariable,&Mutex,&timeout);
-      while(result == EINTR) {
-         unsynchronized();
-         Thread::setCancelState(oldstate);
-         if(oldstate == Thread::TCS_CancelEnabled) {
-            pthread_testcancel();
-         }
-         oldstate = Thread::setCancelState(Thread::TCS_CancelDisabled);
-         synchronized();
-
-         if(Fired) {
-            result = 0;
-         }
-         else {
-            result = pthread_cond_timedwait(&ConditionVariable,&Mutex,&timeout);
-         }
-      }
-   }
-   if(result == 0) {
-      Fired = false;
-   }
-
-   unsynchronized();
-   Thread::setCancelState(oldstate);
-   if(oldstate == Thread::TCS_CancelEnabled) {
-      pthread_testcancel();
-   }
-   return(result == 0);
 }
@@ -40,18 +40,23 @@
 
 #include "tdsystem.h"
 #include "synchronizable.h"
+#include "leancondition.h"
 
 
 
 /**
-  * This class realizes a condition variable.
+  * This class realizes a condition variable. Waiting, firing and parent
+  * propagation are provided by LeanCondition. Additionally, a Condition
+  * is a Synchronizable, i.e. it has its own mutex and name.
   * @short   Condition
   * @author  Thomas Dreibholz (thomas.dreibholz@gmail.com)
   * @version 1.0
   * @see Synchronizable
+  * @see LeanCondition
   * @see Thread
 */
-class Condition : public Synchronizable
+class Condition : public Synchronizable,
+                  public LeanCondition
 {
    // ====== Constructor/Destructor =========================================
    public:
@@ -62,85 +67,15 @@ class Condition : public Synchronizable
      * @param parentCondition Parent condition.
      * @param recursive true to make condition's mutex recursive; false otherwise (default for Condition!).
      */
-   Condition(const char* name            = "Condition",
-             Condition*  parentCondition = NULL,
-             const bool  recursive       = true);
+   Condition(const char*    name            = "Condition",
+             LeanCondition* parentCondition = NULL,
+             const bool     recursive       = true);
 
    /**
      * Destructor.
      */
-   ~Condition();
-
-
-   // ====== Condition variable functions ===================================
-   /**
-     * Fire condition: One thread waiting for this variable will be
-     * resumed.
-     */
-   void signal();
-
-   /**
-     * Broadcast condition: All threads waiting for this variable will be
-     * resumed.
-     */
-   void broadcast();
-
-   /**
-     * Check, if condition has been fired. This call will reset
-     * the fired state.
-     *
-     * @return true, if condition has been fired; false otherwise.
-     */
-   inline bool fired();
-
-   /**
-     * Check, if condition has been fired. This call will *not*
-     * reset the fired state.
-     *
-     * @return true, if condition has been fired; false otherwise.
-     */
-   inline bool peekFired();
-
-   /**
-     * Wait for condition without timeout.
-     */
-   void wait();
-
-   /**
-     * Wait for condition with timeout.
-     *
-     * @param microseconds Timeout in microseconds.
-     * @return true, if condition has been received; false for timeout.
-     */
-   bool timedWait(const card64 microseconds);
-
-
-   // ====== Parent condition management ====================================
-   /**
-     * Add parent condition.
-     *
-     * @param parentCondition Parent condition to be added.
-     */
-   void addParent(Condition* parentCondition);
-
-   /**
-     * Remove parent condition.
-     *
-     * @param parentCondition Parent condition to be removed.
-     */
-   void removeParent(Condition* parentCondition);
-
-
-   // ====== Private data ===================================================
-   private:
-   std::set<Condition*> ParentSet;
-   pthread_cond_t       ConditionVariable;
-   bool                 Fired;
-   bool                 Valid;
+   virtual ~Condition();
 };
 
 
-#include "condition.icc"
-
-
 #endif
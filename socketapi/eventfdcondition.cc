@@ -0,0 +1,122 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Condition with Event Descriptor
+ *
+ */
+
+
+#include "tdsystem.h"
+#include "eventfdcondition.h"
+
+#include <fcntl.h>
+#if (SYSTEM == OS_Linux)
+#include <sys/eventfd.h>
+#endif
+
+
+
+// ###### Constructor #######################################################
+EventFDCondition::EventFDCondition(const char* name)
+   : Condition(name)
+{
+#if (SYSTEM == OS_Linux)
+   ReadFD  = eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+   WriteFD = ReadFD;
+#else
+   int pipeFD[2];
+   if(pipe((int*)&pipeFD) == 0) {
+      ReadFD  = pipeFD[0];
+      WriteFD = pipeFD[1];
+      for(cardinal i = 0;i < 2;i++) {
+         fcntl(pipeFD[i], F_SETFL, fcntl(pipeFD[i], F_GETFL) | O_NONBLOCK);
+         fcntl(pipeFD[i], F_SETFD, FD_CLOEXEC);
+      }
+   }
+   else {
+      ReadFD  = -1;
+      WriteFD = -1;
+   }
+#endif
+   if(ReadFD < 0) {
+#ifndef DISABLE_WARNINGS
+      std::cerr << "ERROR: EventFDCondition::EventFDCondition() - "
+                   "Unable to create event descriptor!" << std::endl;
+#endif
+   }
+}
+
+
+// ###### Destructor ########################################################
+EventFDCondition::~EventFDCondition()
+{
+   if(ReadFD >= 0) {
+      close(ReadFD);
+   }
+   if((WriteFD >= 0) && (WriteFD != ReadFD)) {
+      close(WriteFD);
+   }
+   ReadFD  = -1;
+   WriteFD = -1;
+}
+
+
+// ###### Make event descriptor readable ####################################
+void EventFDCondition::notify()
+{
+   if(WriteFD >= 0) {
+      // A full pipe or eventfd counter is already readable. Therefore,
+      // a failed non-blocking write can be ignored.
+#if (SYSTEM == OS_Linux)
+      uint64_t dummy = 1;
+#else
+      card8    dummy = 1;
+#endif
+      dummy = write(WriteFD,&dummy,sizeof(dummy));
+   }
+}
+
+
+// ###### Signal condition ##################################################
+void EventFDCondition::signal()
+{
+   Condition::signal();
+   notify();
+}
+
+
+// ###### Broadcast condition ###############################################
+void EventFDCondition::broadcast()
+{
+   Condition::broadcast();
+   notify();
+}
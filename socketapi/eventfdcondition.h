@@ -0,0 +1,109 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Condition with Event Descriptor
+ *
+ */
+
+#ifndef EVENTFDCONDITION_H
+#define EVENTFDCONDITION_H
+
+
+#include "tdsystem.h"
+#include "condition.h"
+
+
+
+/**
+  * This class realizes a condition which makes a kernel descriptor
+  * readable when it is fired. It may be added as parent of other
+  * conditions, so that applications can wait for their updates within
+  * their own epoll or io_uring event loop. On Linux, an eventfd is used;
+  * on other systems, a pipe. The application has to read the descriptor
+  * to reset it.
+  *
+  * @short   Condition with Event Descriptor
+  * @author  Thomas Dreibholz (thomas.dreibholz@gmail.com)
+  * @version 1.0
+  * @see Condition
+*/
+class EventFDCondition : public Condition
+{
+   // ====== Constructor/Destructor =========================================
+   public:
+   /**
+     * Constructor.
+     *
+     * @param name Name.
+     */
+   EventFDCondition(const char* name = "EventFDCondition");
+
+   /**
+     * Destructor.
+     */
+   ~EventFDCondition();
+
+
+   // ====== Event descriptor ===============================================
+   /**
+     * Get event descriptor to be read by the application.
+     *
+     * @return Descriptor or -1, if its creation has failed.
+     */
+   inline int getFD() const;
+
+
+   // ====== Condition variable functions ===================================
+   /**
+     * Fire condition and make event descriptor readable.
+     */
+   void signal();
+
+   /**
+     * Broadcast condition and make event descriptor readable.
+     */
+   void broadcast();
+
+
+   // ====== Private data ===================================================
+   private:
+   void notify();
+
+   int ReadFD;
+   int WriteFD;
+};
+
+
+#include "eventfdcondition.icc"
+
+
+#endif
@@ -397,6 +397,43 @@ struct sctp_sack_info {
 #define SCTP_MAXSEG                 1024
 #define SCTP_I_WANT_MAPPED_V4_ADDR  1025
 
+/* SocketAPI extension: receive ring size in bytes (0 = off) */
+#define SCTP_EAGER_RECEIVE          1100
+
+
+
+/* Message header for ext_recvmmsg()/ext_sendmmsg() (like struct mmsghdr of Linux) */
+struct ext_mmsghdr {
+   struct msghdr msg_hdr;
+   unsigned int  msg_len;
+};
+
+
+/* SocketAPI extension: epoll-like event notification (like epoll of Linux) */
+#define EXT_EPOLLIN       0x001
+#define EXT_EPOLLPRI      0x002
+#define EXT_EPOLLOUT      0x004
+#define EXT_EPOLLERR      0x008
+#define EXT_EPOLLHUP      0x010
+#define EXT_EPOLLONESHOT  (1U << 30)
+#define EXT_EPOLLET       (1U << 31)
+
+#define EXT_EPOLL_CTL_ADD 1
+#define EXT_EPOLL_CTL_DEL 2
+#define EXT_EPOLL_CTL_MOD 3
+
+typedef union ext_epoll_data {
+   void*    ptr;
+   int      fd;
+   uint32_t u32;
+   uint64_t u64;
+} ext_epoll_data_t;
+
+struct ext_epoll_event {
+   uint32_t         events;
+   ext_epoll_data_t data;
+};
+
 
 
 #ifdef __cplusplus
@@ -422,13 +459,22 @@ int ext_setsockopt(int sockfd, int level, int optname, const void* optval, sockl
 ssize_t ext_recv(int s, void* buf, size_t len, int flags);
 ssize_t ext_recvfrom(int  s,  void * buf,  size_t len, int flags, struct sockaddr* from, socklen_t* fromlen);
 ssize_t ext_recvmsg(int s, struct msghdr* msg, int flags);
+int ext_recvmmsg(int s, struct ext_mmsghdr* msgvec, unsigned int vlen, int flags);
 ssize_t ext_send(int s, const void* msg, size_t len, int flags);
 ssize_t ext_sendto(int s, const void* msg, size_t len, int flags, const struct sockaddr* to, socklen_t tolen);
 ssize_t ext_sendmsg(int s, const struct msghdr* msg, int flags);
+/* Sends the messages in order and stops at the first failed message. Returns
+   the number of messages sent, or -1 (errno is set) if the first one fails.
+   Messages which may establish an association (SCTP_INIT control data, or
+   a new destination on an auto-connect socket) behave like ext_sendmsg(). */
+int ext_sendmmsg(int s, struct ext_mmsghdr* msgvec, unsigned int vlen, int flags);
 ssize_t ext_read(int fd, void* buf, size_t count);
 ssize_t ext_write(int fd, const void* buf, size_t count);
 int ext_select(int n, fd_set* readfds, fd_set* writefds, fd_set* exceptfds, struct timeval* timeout);
 int ext_poll(struct pollfd* fdlist, long unsigned int count, int time);
+int ext_epoll_create(int size);
+int ext_epoll_ctl(int epfd, int op, int fd, struct ext_epoll_event* event);
+int ext_epoll_wait(int epfd, struct ext_epoll_event* events, int maxevents, int timeout);
 
 
 /* For internal usage only! */
@@ -499,6 +545,22 @@ int ext_pipe(int fds[2]);
   */
 int sctp_isavailable();
 
+/**
+  * Get event descriptor of an SCTP socket. It is a kernel descriptor
+  * (an eventfd on Linux), which becomes readable when the read, write or
+  * exception state of the socket changes. Therefore, it can be added to
+  * an application's own epoll or io_uring event loop. The application
+  * has to read the descriptor to reset it, and then check the socket
+  * state, e.g. by non-blocking I/O or ext_poll() with zero timeout.
+  * The descriptor belongs to the association of a connected one-to-one
+  * style socket, otherwise to the socket itself. Therefore, it has to be
+  * obtained again after connecting. It is closed by ext_close().
+  *
+  * @param sd Socket descriptor.
+  * @return Event descriptor or -1 in case of error (errno is set).
+  */
+int sctp_eventfd(int sd);
+
 /**
   * Enable or disable OOTB handling.
   *
@@ -541,9 +603,11 @@ int sctp_enableCRC32(const unsigned int enable);
 #define ext_recv(a,b,c,d) ::recv(a,b,c,d)
 #define ext_recvfrom(a,b,c,d,e,f) ::recvfrom(a,b,c,d,e,f)
 #define ext_recvmsg(a,b,c) ::recvmsg(a,b,c)
+#define ext_recvmmsg(a,b,c,d) ::recvmmsg(a,b,c,d,NULL)
 #define ext_send(a,b,c,d) ::send(a,b,c,d)
 #define ext_sendto(a,b,c,d,e,f) ::sendto(a,b,c,d,e,f)
 #define ext_sendmsg(a,b,c) ::sendmsg(a,b,c)
+#define ext_sendmmsg(a,b,c,d) ::sendmmsg(a,b,c,d)
 #define ext_read(a,b,c) ::read(a,b,c)
 #define ext_write(a,b,c) ::write(a,b,c)
 #define ext_select(a,b,c,d,e) ::select(a,b,c,d,e)
@@ -568,9 +632,11 @@ int sctp_enableCRC32(const unsigned int enable);
 #define ext_recv(a,b,c,d) recv(a,b,c,d)
 #define ext_recvfrom(a,b,c,d,e,f) recvfrom(a,b,c,d,e,f)
 #define ext_recvmsg(a,b,c) recvmsg(a,b,c)
+#define ext_recvmmsg(a,b,c,d) recvmmsg(a,b,c,d,NULL)
 #define ext_send(a,b,c,d) send(a,b,c,d)
 #define ext_sendto(a,b,c,d,e,f) sendto(a,b,c,d,e,f)
 #define ext_sendmsg(a,b,c) sendmsg(a,b,c)
+#define ext_sendmmsg(a,b,c,d) sendmmsg(a,b,c,d)
 #define ext_read(a,b,c) read(a,b,c)
 #define ext_write(a,b,c) write(a,b,c)
 #define ext_select(a,b,c,d,e) select(a,b,c,d,e)
@@ -590,6 +656,29 @@ int sctp_enableCRC32(const unsigned int enable);
 #define SCTP_DELAYED_SACK SCTP_DELAYED_ACK_TIME
 #endif
 
+#include <sys/epoll.h>
+
+#define ext_mmsghdr mmsghdr
+
+#define ext_epoll_create(a) epoll_create(a)
+#define ext_epoll_ctl(a,b,c,d) epoll_ctl(a,b,c,d)
+#define ext_epoll_wait(a,b,c,d) epoll_wait(a,b,c,d)
+#define ext_epoll_event epoll_event
+#define ext_epoll_data_t epoll_data_t
+#define EXT_EPOLLIN       EPOLLIN
+#define EXT_EPOLLPRI      EPOLLPRI
+#define EXT_EPOLLOUT      EPOLLOUT
+#define EXT_EPOLLERR      EPOLLERR
+#define EXT_EPOLLHUP      EPOLLHUP
+#define EXT_EPOLLONESHOT  EPOLLONESHOT
+#define EXT_EPOLLET       EPOLLET
+#define EXT_EPOLL_CTL_ADD EPOLL_CTL_ADD
+#define EXT_EPOLL_CTL_DEL EPOLL_CTL_DEL
+#define EXT_EPOLL_CTL_MOD EPOLL_CTL_MOD
+
+/* Kernel SCTP sockets can be waited for directly. */
+#define sctp_eventfd(a) (a)
+
 #endif
 
 #endif
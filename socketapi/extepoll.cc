@@ -0,0 +1,608 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Epoll-like Event Notification
+ *
+ */
+
+
+#include "tdsystem.h"
+#include "extepoll.h"
+#include "tools.h"
+
+#include <poll.h>
+
+
+
+ExtEpoll* ExtEpoll::FirstInstance = NULL;
+
+
+
+// ###### Entry condition constructor #######################################
+ExtEpoll::EntryCondition::EntryCondition()
+   : Condition("ExtEpoll::EntryCondition")
+{
+   Owner = NULL;
+}
+
+
+// ###### Child condition has been signalled ################################
+void ExtEpoll::EntryCondition::signal()
+{
+   broadcast();
+}
+
+
+// ###### Child condition has been broadcasted ##############################
+void ExtEpoll::EntryCondition::broadcast()
+{
+   // Nobody waits for the entry condition itself. Just queue the entry.
+   if(Owner != NULL) {
+      Owner->Epoll->markReady(Owner);
+   }
+}
+
+
+// ###### Constructor #######################################################
+ExtEpoll::ExtEpoll()
+   : ReadyCondition("ExtEpoll::ReadyCondition")
+{
+   FirstReady = NULL;
+   LastReady  = NULL;
+   References = 0;
+   Closed     = false;
+
+   SCTPSocketMaster::MasterInstance.lock();
+   NextInstance  = FirstInstance;
+   FirstInstance = this;
+   SCTPSocketMaster::MasterInstance.unlock();
+}
+
+
+// ###### Destructor ########################################################
+ExtEpoll::~ExtEpoll()
+{
+   SCTPSocketMaster::MasterInstance.lock();
+   ExtEpoll** instance = &FirstInstance;
+   while(*instance != NULL) {
+      if(*instance == this) {
+         *instance = NextInstance;
+         break;
+      }
+      instance = &((*instance)->NextInstance);
+   }
+   while(!EntryMap.empty()) {
+      removeEntry(EntryMap.begin()->second);
+   }
+   SCTPSocketMaster::MasterInstance.unlock();
+}
+
+
+// ###### Obtain reference to instance of descriptor ########################
+ExtEpoll* ExtEpoll::obtain(ExtSocketDescriptor* descriptor)
+{
+   ExtEpoll* epoll = NULL;
+   SCTPSocketMaster::MasterInstance.lock();
+   if((descriptor->Type == ExtSocketDescriptor::ESDT_Epoll) &&
+      (descriptor->Socket.EpollPtr != NULL) &&
+      (!descriptor->Socket.EpollPtr->Closed)) {
+      epoll = descriptor->Socket.EpollPtr;
+      epoll->References++;
+   }
+   SCTPSocketMaster::MasterInstance.unlock();
+   return(epoll);
+}
+
+
+// ###### Release reference to instance #####################################
+void ExtEpoll::release(ExtEpoll* epoll)
+{
+   SCTPSocketMaster::MasterInstance.lock();
+   epoll->References--;
+   if((epoll->Closed) && (epoll->References == 0)) {
+      delete epoll;
+   }
+   SCTPSocketMaster::MasterInstance.unlock();
+}
+
+
+// ###### Close instance ####################################################
+void ExtEpoll::close(ExtEpoll* epoll)
+{
+   SCTPSocketMaster::MasterInstance.lock();
+   epoll->Closed = true;
+   while(!epoll->EntryMap.empty()) {
+      epoll->removeEntry(epoll->EntryMap.begin()->second);
+   }
+   if(epoll->References == 0) {
+      delete epoll;
+   }
+   else {
+      // Waiters notice Closed and release their references.
+      epoll->ReadyCondition.broadcast();
+   }
+   SCTPSocketMaster::MasterInstance.unlock();
+}
+
+
+// ###### Attach entry to its update conditions #############################
+void ExtEpoll::attach(Entry* entry)
+{
+   const uint32_t events = entry->Event.events;
+
+   if(entry->Descriptor->Type == ExtSocketDescriptor::ESDT_System) {
+      SCTPSocketMaster::UserSocketNotification* usn =
+         new SCTPSocketMaster::UserSocketNotification;
+      usn->FileDescriptor = entry->Descriptor->Socket.SystemSocketID;
+      usn->EventMask      = 0;
+      if(events & EXT_EPOLLIN) {
+         usn->EventMask |= POLLIN;
+      }
+      if(events & EXT_EPOLLPRI) {
+         usn->EventMask |= POLLPRI;
+      }
+      if(events & EXT_EPOLLOUT) {
+         usn->EventMask |= POLLOUT;
+      }
+      usn->UpdateCondition.addParent(&entry->UpdateCondition);
+      SCTPSocketMaster::MasterInstance.addUserSocketNotification(usn);
+      entry->UserNotification = usn;
+   }
+   else if(entry->Descriptor->Type == ExtSocketDescriptor::ESDT_SCTP) {
+      SCTPAssociation* association = entry->Descriptor->Socket.SCTPSocketDesc.SCTPAssociationPtr;
+      SCTPSocket*      socket      = entry->Descriptor->Socket.SCTPSocketDesc.SCTPSocketPtr;
+
+      UpdateConditionType types[3];
+      cardinal            count = 0;
+      if(events & (EXT_EPOLLIN|EXT_EPOLLPRI)) {
+         types[count++] = UCT_Read;
+      }
+      if(events & EXT_EPOLLOUT) {
+         types[count++] = UCT_Write;
+      }
+      types[count++] = UCT_Except;
+
+      for(cardinal i = 0;i < count;i++) {
+         LeanCondition* condition = NULL;
+         if(association != NULL) {
+            condition = association->getUpdateCondition(types[i]);
+         }
+         else if(socket != NULL) {
+            condition = socket->getUpdateCondition(types[i]);
+         }
+         if(condition != NULL) {
+            condition->addParent(&entry->UpdateCondition);
+            entry->AttachedCondition[entry->Attached++] = condition;
+         }
+      }
+   }
+}
+
+
+// ###### Detach entry from its update conditions ###########################
+void ExtEpoll::detach(Entry* entry)
+{
+   for(cardinal i = 0;i < entry->Attached;i++) {
+      entry->AttachedCondition[i]->removeParent(&entry->UpdateCondition);
+   }
+   entry->Attached = 0;
+
+   if(entry->UserNotification != NULL) {
+      SCTPSocketMaster::MasterInstance.deleteUserSocketNotification(entry->UserNotification);
+      entry->UserNotification->UpdateCondition.removeParent(&entry->UpdateCondition);
+      delete entry->UserNotification;
+      entry->UserNotification = NULL;
+   }
+}
+
+
+// ###### Append entry to ready list ########################################
+void ExtEpoll::markReady(Entry* entry)
+{
+   ReadyCondition.synchronized();
+   if((!entry->Queued) && (!entry->Disabled)) {
+      entry->Queued    = true;
+      entry->NextReady = NULL;
+      if(LastReady != NULL) {
+         LastReady->NextReady = entry;
+      }
+      else {
+         FirstReady = entry;
+      }
+      LastReady = entry;
+      ReadyCondition.broadcast();
+   }
+   ReadyCondition.unsynchronized();
+}
+
+
+// ###### Remove entry ######################################################
+void ExtEpoll::removeEntry(Entry* entry)
+{
+   detach(entry);
+
+   ReadyCondition.synchronized();
+   if(entry->Queued) {
+      Entry* previous = NULL;
+      for(Entry* e = FirstReady;e != NULL;e = e->NextReady) {
+         if(e == entry) {
+            if(previous != NULL) {
+               previous->NextReady = e->NextReady;
+            }
+            else {
+               FirstReady = e->NextReady;
+            }
+            if(LastReady == e) {
+               LastReady = previous;
+            }
+            break;
+         }
+         previous = e;
+      }
+   }
+   ReadyCondition.unsynchronized();
+
+   EntryMap.erase(entry->FD);
+   delete entry;
+}
+
+
+// ###### Get current events of an entry ####################################
+uint32_t ExtEpoll::getEvents(Entry* entry)
+{
+   uint32_t events = 0;
+
+   if(entry->Descriptor->Type == ExtSocketDescriptor::ESDT_System) {
+      if(entry->UserNotification != NULL) {
+         const short int usnEvents = entry->UserNotification->Events;
+         if(usnEvents & POLLIN) {
+            events |= EXT_EPOLLIN;
+         }
+         if(usnEvents & POLLPRI) {
+            events |= EXT_EPOLLPRI;
+         }
+         if(usnEvents & POLLOUT) {
+            events |= EXT_EPOLLOUT;
+         }
+         if(usnEvents & (POLLERR|POLLNVAL)) {
+            events |= EXT_EPOLLERR;
+         }
+         if(usnEvents & POLLHUP) {
+            events |= EXT_EPOLLHUP;
+         }
+      }
+   }
+   else if(entry->Descriptor->Type == ExtSocketDescriptor::ESDT_SCTP) {
+      SCTPAssociation* association = entry->Descriptor->Socket.SCTPSocketDesc.SCTPAssociationPtr;
+      SCTPSocket*      socket      = entry->Descriptor->Socket.SCTPSocketDesc.SCTPSocketPtr;
+      if(association != NULL) {
+         if(association->isReady(UCT_Read)) {
+            events |= EXT_EPOLLIN;
+         }
+         if(association->isReady(UCT_Write)) {
+            events |= EXT_EPOLLOUT;
+         }
+         if(association->isReady(UCT_Except)) {
+            events |= EXT_EPOLLERR;
+         }
+      }
+      else if(socket != NULL) {
+         if(socket->isReady(UCT_Read)) {
+            events |= EXT_EPOLLIN;
+         }
+         // A connectionless socket is always writable.
+         if((!entry->Descriptor->Socket.SCTPSocketDesc.ConnectionOriented) ||
+            (socket->isReady(UCT_Write))) {
+            events |= EXT_EPOLLOUT;
+         }
+         if(socket->isReady(UCT_Except)) {
+            events |= EXT_EPOLLERR;
+         }
+      }
+   }
+
+   return(events & (entry->Event.events | EXT_EPOLLERR | EXT_EPOLLHUP));
+}
+
+
+// ###### Add, modify or remove registration ################################
+int ExtEpoll::control(const int                     op,
+                      const int                     fd,
+                      ExtSocketDescriptor*          descriptor,
+                      const struct ext_epoll_event* event)
+{
+   if((op != EXT_EPOLL_CTL_DEL) && (event == NULL)) {
+      return(-EFAULT);
+   }
+   if((descriptor->Type != ExtSocketDescriptor::ESDT_System) &&
+      (descriptor->Type != ExtSocketDescriptor::ESDT_SCTP)) {
+      return(-EPERM);
+   }
+
+   int result = 0;
+   SCTPSocketMaster::MasterInstance.lock();
+   std::map<int, Entry*>::iterator found = EntryMap.find(fd);
+   switch(op) {
+      case EXT_EPOLL_CTL_ADD:
+         if(found != EntryMap.end()) {
+            result = -EEXIST;
+         }
+         else {
+            Entry* entry = new Entry;
+            entry->Epoll            = this;
+            entry->FD               = fd;
+            entry->Descriptor       = descriptor;
+            entry->Event            = *event;
+            entry->Queued           = false;
+            entry->Disabled         = false;
+            entry->NextReady        = NULL;
+            entry->Attached         = 0;
+            entry->UserNotification = NULL;
+            entry->UpdateCondition.Owner = entry;
+            EntryMap.insert(std::pair<int, Entry*>(fd, entry));
+            attach(entry);
+            // Let the next wait() check the current state.
+            markReady(entry);
+         }
+       break;
+      case EXT_EPOLL_CTL_MOD:
+         if(found == EntryMap.end()) {
+            result = -ENOENT;
+         }
+         else {
+            Entry* entry = found->second;
+            detach(entry);
+            ReadyCondition.synchronized();
+            entry->Event    = *event;
+            entry->Disabled = false;
+            ReadyCondition.unsynchronized();
+            attach(entry);
+            markReady(entry);
+         }
+       break;
+      case EXT_EPOLL_CTL_DEL:
+         if(found == EntryMap.end()) {
+            result = -ENOENT;
+         }
+         else {
+            removeEntry(found->second);
+         }
+       break;
+      default:
+         result = -EINVAL;
+       break;
+   }
+   SCTPSocketMaster::MasterInstance.unlock();
+   return(result);
+}
+
+
+// ###### Wait for events ###################################################
+int ExtEpoll::wait(struct ext_epoll_event* events,
+                   const int               maxEvents,
+                   const int               timeout)
+{
+   if((events == NULL) || (maxEvents <= 0)) {
+      return(-EINVAL);
+   }
+   if(!SCTPSocketMaster::MasterInstance.running()) {
+      return(pollSystemDescriptors(events, maxEvents, timeout));
+   }
+
+   const card64 waitStart = getMicroTime();
+   for(;;) {
+      int count = 0;
+
+      SCTPSocketMaster::MasterInstance.lock();
+      if(Closed) {
+         SCTPSocketMaster::MasterInstance.unlock();
+         return(-EBADF);
+      }
+
+      // ====== Take the ready list =========================================
+      ReadyCondition.synchronized();
+      Entry* readyList = FirstReady;
+      FirstReady = NULL;
+      LastReady  = NULL;
+      ReadyCondition.unsynchronized();
+
+      // ====== Check ready entries =========================================
+      while(readyList != NULL) {
+         // Entries stay marked as queued while being in readyList, so that
+         // markReady() does not modify their NextReady pointers.
+         ReadyCondition.synchronized();
+         Entry* entry = readyList;
+         readyList        = entry->NextReady;
+         entry->NextReady = NULL;
+         entry->Queued    = false;
+         ReadyCondition.unsynchronized();
+
+         if(count >= maxEvents) {
+            markReady(entry);
+            continue;
+         }
+
+         const uint32_t ready = getEvents(entry);
+         if(ready != 0) {
+            events[count].events = ready;
+            events[count].data   = entry->Event.data;
+            count++;
+            if(entry->Event.events & EXT_EPOLLONESHOT) {
+               ReadyCondition.synchronized();
+               entry->Disabled = true;
+               ReadyCondition.unsynchronized();
+            }
+            else if((!(entry->Event.events & EXT_EPOLLET)) &&
+                    (entry->Descriptor->Type == ExtSocketDescriptor::ESDT_SCTP)) {
+               // Level-triggered: check again on next wait().
+               markReady(entry);
+            }
+         }
+
+         // sctplib removes the user callback after its first notification.
+         if((entry->UserNotification != NULL) && (!entry->Disabled)) {
+            SCTPSocketMaster::MasterInstance.addUserSocketNotification(entry->UserNotification);
+         }
+      }
+
+      SCTPSocketMaster::MasterInstance.unlock();
+
+      // ====== Wait for updates ============================================
+      if((count > 0) || (timeout == 0)) {
+         return(count);
+      }
+      if(timeout < 0) {
+         ReadyCondition.wait();
+      }
+      else {
+         const card64 elapsed = getMicroTime() - waitStart;
+         const card64 limit   = (card64)timeout * 1000;
+         if((elapsed >= limit) || (!ReadyCondition.timedWait(limit - elapsed))) {
+            return(0);
+         }
+      }
+   }
+}
+
+
+// ###### Wait for system descriptors without SCTP master ###################
+int ExtEpoll::pollSystemDescriptors(struct ext_epoll_event* events,
+                                    const int               maxEvents,
+                                    const int               timeout)
+{
+   // Without running SCTP master thread, there are no SCTP sockets.
+   // Therefore, simply use poll() on the registered system descriptors.
+   SCTPSocketMaster::MasterInstance.lock();
+   pollfd*  fds   = new pollfd[EntryMap.size() + 1];
+   cardinal count = 0;
+   for(std::map<int, Entry*>::iterator iterator = EntryMap.begin();
+       iterator != EntryMap.end(); iterator++) {
+      Entry* entry = iterator->second;
+      if((entry->Descriptor->Type == ExtSocketDescriptor::ESDT_System) &&
+         (!entry->Disabled)) {
+         fds[count].fd      = entry->Descriptor->Socket.SystemSocketID;
+         fds[count].events  = 0;
+         fds[count].revents = 0;
+         if(entry->Event.events & EXT_EPOLLIN) {
+            fds[count].events |= POLLIN;
+         }
+         if(entry->Event.events & EXT_EPOLLPRI) {
+            fds[count].events |= POLLPRI;
+         }
+         if(entry->Event.events & EXT_EPOLLOUT) {
+            fds[count].events |= POLLOUT;
+         }
+         count++;
+      }
+   }
+   SCTPSocketMaster::MasterInstance.unlock();
+
+   int result = ::poll(fds, count, timeout);
+   if(result > 0) {
+      result = 0;
+      SCTPSocketMaster::MasterInstance.lock();
+      for(cardinal i = 0;(i < count) && (result < maxEvents);i++) {
+         if(fds[i].revents == 0) {
+            continue;
+         }
+         // The entry may have been removed in the meantime.
+         for(std::map<int, Entry*>::iterator iterator = EntryMap.begin();
+             iterator != EntryMap.end(); iterator++) {
+            Entry* entry = iterator->second;
+            if((entry->Descriptor->Type == ExtSocketDescriptor::ESDT_System) &&
+               (entry->Descriptor->Socket.SystemSocketID == fds[i].fd) &&
+               (!entry->Disabled)) {
+               uint32_t ready = 0;
+               if(fds[i].revents & POLLIN) {
+                  ready |= EXT_EPOLLIN;
+               }
+               if(fds[i].revents & POLLPRI) {
+                  ready |= EXT_EPOLLPRI;
+               }
+               if(fds[i].revents & POLLOUT) {
+                  ready |= EXT_EPOLLOUT;
+               }
+               if(fds[i].revents & (POLLERR|POLLNVAL)) {
+                  ready |= EXT_EPOLLERR;
+               }
+               if(fds[i].revents & POLLHUP) {
+                  ready |= EXT_EPOLLHUP;
+               }
+               events[result].events = ready;
+               events[result].data   = entry->Event.data;
+               result++;
+               if(entry->Event.events & EXT_EPOLLONESHOT) {
+                  entry->Disabled = true;
+               }
+               break;
+            }
+         }
+      }
+      SCTPSocketMaster::MasterInstance.unlock();
+   }
+   else if(result < 0) {
+      result = -errno;
+   }
+   delete [] fds;
+   return(result);
+}
+
+
+// ###### Update registrations of a descriptor ##############################
+void ExtEpoll::updateDescriptor(const int fd)
+{
+   SCTPSocketMaster::MasterInstance.lock();
+   for(ExtEpoll* epoll = FirstInstance;epoll != NULL;epoll = epoll->NextInstance) {
+      std::map<int, Entry*>::iterator found = epoll->EntryMap.find(fd);
+      if(found != epoll->EntryMap.end()) {
+         Entry* entry = found->second;
+         epoll->detach(entry);
+         epoll->attach(entry);
+         epoll->markReady(entry);
+      }
+   }
+   SCTPSocketMaster::MasterInstance.unlock();
+}
+
+
+// ###### Remove registrations of a descriptor ##############################
+void ExtEpoll::removeDescriptor(const int fd)
+{
+   SCTPSocketMaster::MasterInstance.lock();
+   for(ExtEpoll* epoll = FirstInstance;epoll != NULL;epoll = epoll->NextInstance) {
+      std::map<int, Entry*>::iterator found = epoll->EntryMap.find(fd);
+      if(found != epoll->EntryMap.end()) {
+         epoll->removeEntry(found->second);
+      }
+   }
+   SCTPSocketMaster::MasterInstance.unlock();
+}
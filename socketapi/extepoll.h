@@ -0,0 +1,218 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Epoll-like Event Notification
+ *
+ */
+
+#ifndef EXTEPOLL_H
+#define EXTEPOLL_H
+
+
+#include "tdsystem.h"
+#include "condition.h"
+#include "ext_socket.h"
+#include "extsocketdescriptor.h"
+#include "sctpsocketmaster.h"
+
+#include <map>
+
+
+
+/**
+  * This class realizes an epoll-like event notification for the
+  * descriptors of ExtSocketDescriptorMaster. In contrast to ext_select(),
+  * registrations are persistent: an entry's EntryCondition is added as
+  * parent of the update conditions of the SCTP socket or association
+  * once, and a UserSocketNotification for a system descriptor remains
+  * registered at sctplib. When a child condition fires, the entry is
+  * appended to the ready list. Therefore, wait() only has to look at
+  * the ready entries.
+  *
+  * Level-triggered entries are queued again after being reported, so that
+  * the next wait() checks them again. Edge-triggered entries are only
+  * reported on new updates. For system descriptors, the user callback of
+  * sctplib is level-triggered; therefore, EXT_EPOLLET has no effect there.
+  *
+  * Locking: control() and wait() obtain the SCTPSocketMaster lock.
+  * The ready list is protected by the ReadyCondition lock, which is on
+  * the Condition level of the lock hierarchy.
+  *
+  * Lifetime: callers of control() and wait() hold a reference obtained by
+  * obtain(). close() only marks the instance as closed and wakes up its
+  * waiters; the object is deleted when the last reference is released.
+  *
+  * @short   Epoll-like Event Notification
+  * @author  Thomas Dreibholz (thomas.dreibholz@gmail.com)
+  * @version 1.0
+  *
+  * @see SCTPSocketMaster
+  */
+class ExtEpoll
+{
+   // ====== Constructor/Destructor =========================================
+   public:
+   /**
+     * Constructor.
+     */
+   ExtEpoll();
+
+   /**
+     * Destructor.
+     */
+   ~ExtEpoll();
+
+
+   // ====== Epoll functions ================================================
+   /**
+     * Add, modify or remove registration of a descriptor.
+     *
+     * @param op Operation (EXT_EPOLL_CTL_ADD, EXT_EPOLL_CTL_MOD or EXT_EPOLL_CTL_DEL).
+     * @param fd Descriptor.
+     * @param descriptor ExtSocketDescriptor of fd.
+     * @param event Events and user data (ignored for EXT_EPOLL_CTL_DEL).
+     * @return 0 for success; error code (<0) otherwise.
+     */
+   int control(const int                     op,
+               const int                     fd,
+               ExtSocketDescriptor*          descriptor,
+               const struct ext_epoll_event* event);
+
+   /**
+     * Wait for events.
+     *
+     * @param events Array to store events to.
+     * @param maxEvents Size of events array.
+     * @param timeout Timeout in milliseconds (-1 for infinite).
+     * @return Number of events; error code (<0) otherwise.
+     */
+   int wait(struct ext_epoll_event* events,
+            const int               maxEvents,
+            const int               timeout);
+
+
+   // ====== Reference handling =============================================
+   /**
+     * Obtain a reference to the ExtEpoll instance of a descriptor for
+     * calling control() or wait(). The reference has to be released by
+     * release().
+     *
+     * @param descriptor ExtSocketDescriptor.
+     * @return ExtEpoll or NULL, if the descriptor is no open epoll instance.
+     */
+   static ExtEpoll* obtain(ExtSocketDescriptor* descriptor);
+
+   /**
+     * Release a reference obtained by obtain(). The instance is deleted
+     * when it has been closed and this has been the last reference.
+     *
+     * @param epoll ExtEpoll.
+     */
+   static void release(ExtEpoll* epoll);
+
+   /**
+     * Close an instance: remove all registrations, wake up all threads
+     * waiting in wait() and delete it when it is no longer referenced.
+     *
+     * @param epoll ExtEpoll.
+     */
+   static void close(ExtEpoll* epoll);
+
+
+   // ====== Descriptor updates =============================================
+   /**
+     * Update the registrations of a descriptor in all instances, e.g. after
+     * an association has been established for it.
+     *
+     * @param fd Descriptor.
+     */
+   static void updateDescriptor(const int fd);
+
+   /**
+     * Remove the registrations of a descriptor from all instances. This
+     * must be called before the descriptor is closed.
+     *
+     * @param fd Descriptor.
+     */
+   static void removeDescriptor(const int fd);
+
+
+   // ====== Private data ===================================================
+   private:
+   struct Entry;
+
+   class EntryCondition : public Condition
+   {
+      public:
+      EntryCondition();
+      void signal();
+      void broadcast();
+
+      Entry* Owner;
+   };
+
+   struct Entry {
+      ExtEpoll*                                 Epoll;
+      int                                       FD;
+      ExtSocketDescriptor*                      Descriptor;
+      struct ext_epoll_event                    Event;
+      bool                                      Queued;
+      bool                                      Disabled;
+      Entry*                                    NextReady;
+      EntryCondition                            UpdateCondition;
+      cardinal                                  Attached;
+      LeanCondition*                            AttachedCondition[3];
+      SCTPSocketMaster::UserSocketNotification* UserNotification;
+   };
+
+   void attach(Entry* entry);
+   void detach(Entry* entry);
+   void markReady(Entry* entry);
+   void removeEntry(Entry* entry);
+   uint32_t getEvents(Entry* entry);
+   int pollSystemDescriptors(struct ext_epoll_event* events,
+                             const int               maxEvents,
+                             const int               timeout);
+
+   std::map<int, Entry*>     EntryMap;
+   Condition                 ReadyCondition;
+   Entry*                    FirstReady;
+   Entry*                    LastReady;
+   ExtEpoll*                 NextInstance;
+   cardinal                  References;
+   bool                      Closed;
+
+   static ExtEpoll*          FirstInstance;
+};
+
+
+#endif
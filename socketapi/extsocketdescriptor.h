@@ -40,10 +40,13 @@
 
 
 #include "tdsystem.h"
+#include "synchronizable.h"
 #include "sctpsocket.h"
 #include "sctpassociation.h"
 
 
+class ExtEpoll;
+
 
 // ###### ExtSocketDescriptor structure #####################################
 struct ExtSocketDescriptor
@@ -51,13 +54,15 @@ struct ExtSocketDescriptor
    enum ExtSocketDescriptorTypes {
       ESDT_Invalid = 0,
       ESDT_System  = 1,
-      ESDT_SCTP    = 2
+      ESDT_SCTP    = 2,
+      ESDT_Epoll   = 3
    };
 
    unsigned int Type;
 
    union ExtSocketDescriptorUnion {
-      int SystemSocketID;
+      int       SystemSocketID;
+      ExtEpoll* EpollPtr;
       struct SCTP {
          int              Domain;
          int              Type;
@@ -83,12 +88,36 @@ class ExtSocketDescriptorMaster
 
    public:
    inline static ExtSocketDescriptor* getSocket(const int id);
+   inline static unsigned int getSocketLimit();
    static int setSocket(const ExtSocketDescriptor& newSocket);
-   static const unsigned int MaxSockets = FD_SETSIZE;
+   static void releaseSocket(const int id);
+
+   // The descriptor table consists of pages, which are allocated on demand.
+   // Pages are never moved or freed, i.e. pointers returned by getSocket()
+   // remain valid and the lookup cost is constant.
+   static const unsigned int PageSize   = FD_SETSIZE;
+   static const unsigned int MaxPages   = 256;
+   static const unsigned int MaxSockets = PageSize * MaxPages;
 
    private:
+   static ExtSocketDescriptor* allocatePage();
+   static int findFreeSocket();
+   static void markUsed(const unsigned int id);
+   static void markFree(const unsigned int id);
+
    static ExtSocketDescriptorMaster MasterInstance;
-   static ExtSocketDescriptor Sockets[MaxSockets];
+   static ExtSocketDescriptor*      Pages[MaxPages];
+   static unsigned int              PageCount;
+
+   // Free slots are kept in bitmaps (bit set = slot free), with a summary
+   // bitmap of the pages having free slots. Allocation takes the highest
+   // free ID of the lowest page having free slots, by searching both levels
+   // with a bit scan. The table lock is a non-recursive leaf lock on the
+   // Condition level of SCTPSocketMaster's lock hierarchy.
+   static const unsigned int        WordBits = 64;
+   static Synchronizable            TableLock;
+   static card64                    FreeMap[MaxPages][PageSize / WordBits];
+   static card64                    FreePageMap[MaxPages / WordBits];
 };
 
 
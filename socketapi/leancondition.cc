@@ -0,0 +1,334 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Lean Condition
+ *
+ */
+
+
+#include "tdsystem.h"
+#include "leancondition.h"
+#include "thread.h"
+#include "tools.h"
+
+#include <sys/time.h>
+#include <limits.h>
+#if (SYSTEM == OS_Linux)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+
+
+// ====== Sleep on and wake up 32-bit words =================================
+#if (SYSTEM == OS_Linux)
+// ###### Sleep while *word == value #######################################
+static void futexWait(card32* word, const card32 value, const card64 microseconds)
+{
+   timespec timeout;
+   timeout.tv_sec  = (time_t)(microseconds / 1000000);
+   timeout.tv_nsec = (long)(microseconds % 1000000) * 1000;
+   syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, value, &timeout, NULL, 0);
+}
+
+
+// ###### Wake up threads sleeping on word ##################################
+static void futexWake(card32* word, const bool all)
+{
+   syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, (all == true) ? INT_MAX : 1, NULL, NULL, 0);
+}
+
+#else
+// Without futex, the sleeping threads are parked on a condition variable
+// of a small static table, selected by the word's address. Threads of
+// different words may share a slot; they just see spurious wakeups.
+struct ParkingSlot {
+   pthread_mutex_t Mutex;
+   pthread_cond_t  Condition;
+};
+
+#define PARKING_SLOT { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER }
+static ParkingSlot ParkingLot[8] = {
+   PARKING_SLOT, PARKING_SLOT, PARKING_SLOT, PARKING_SLOT,
+   PARKING_SLOT, PARKING_SLOT, PARKING_SLOT, PARKING_SLOT
+};
+#undef PARKING_SLOT
+
+
+// ###### Get parking slot for word #########################################
+static inline ParkingSlot& getParkingSlot(const card32* word)
+{
+   return(ParkingLot[((unsigned long)word / sizeof(void*)) %
+                     (sizeof(ParkingLot) / sizeof(ParkingLot[0]))]);
+}
+
+
+// ###### Sleep while *word == value #######################################
+static void futexWait(card32* word, const card32 value, const card64 microseconds)
+{
+   ParkingSlot& slot = getParkingSlot(word);
+
+   timeval  now;
+   timespec timeout;
+   gettimeofday(&now,NULL);
+   timeout.tv_sec  = now.tv_sec + (long)(microseconds / 1000000);
+   timeout.tv_nsec = (now.tv_usec + (long)(microseconds % 1000000)) * 1000;
+   if(timeout.tv_nsec >= 1000000000) {
+      timeout.tv_sec++;
+      timeout.tv_nsec -= 1000000000;
+   }
+
+   pthread_mutex_lock(&slot.Mutex);
+   if(__atomic_load_n(word, __ATOMIC_SEQ_CST) == value) {
+      pthread_cond_timedwait(&slot.Condition, &slot.Mutex, &timeout);
+   }
+   pthread_mutex_unlock(&slot.Mutex);
+}
+
+
+// ###### Wake up threads sleeping on word ##################################
+static void futexWake(card32* word, const bool all)
+{
+   ParkingSlot& slot = getParkingSlot(word);
+   pthread_mutex_lock(&slot.Mutex);
+   pthread_cond_broadcast(&slot.Condition);
+   pthread_mutex_unlock(&slot.Mutex);
+}
+#endif
+
+
+
+// ###### Constructor #######################################################
+LeanCondition::LeanCondition(LeanCondition* parentCondition)
+{
+   Sequence       = 0;
+   Waiters        = 0;
+   ParentLock     = 0;
+   Fired          = false;
+   Parents        = 0;
+   ParentCapacity = InlineParents;
+   ParentList     = (LeanCondition**)&ParentArray;
+   addParent(parentCondition);
+}
+
+
+// ###### Destructor ########################################################
+LeanCondition::~LeanCondition()
+{
+   if(__atomic_load_n(&Waiters, __ATOMIC_SEQ_CST) != 0) {
+#ifndef DISABLE_WARNINGS
+      std::cerr << "ERROR: LeanCondition::~LeanCondition() - "
+                   "Another thread is still waiting for this condition!" << std::endl;
+      abort();
+#endif
+   }
+   if(ParentList != (LeanCondition**)&ParentArray) {
+      delete [] ParentList;
+   }
+   ParentList = NULL;
+}
+
+
+// ###### Lock parent list ##################################################
+void LeanCondition::lockParents()
+{
+   card32 state = 0;
+   if(!__atomic_compare_exchange_n(&ParentLock, &state, 1, false,
+                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+      if(state != 2) {
+         state = __atomic_exchange_n(&ParentLock, 2, __ATOMIC_ACQUIRE);
+      }
+      while(state != 0) {
+         futexWait(&ParentLock, 2, 1000000);
+         state = __atomic_exchange_n(&ParentLock, 2, __ATOMIC_ACQUIRE);
+      }
+   }
+}
+
+
+// ###### Unlock parent list ################################################
+void LeanCondition::unlockParents()
+{
+   if(__atomic_exchange_n(&ParentLock, 0, __ATOMIC_RELEASE) == 2) {
+      futexWake(&ParentLock, false);
+   }
+}
+
+
+// ###### Add parent condition ##############################################
+void LeanCondition::addParent(LeanCondition* parentCondition)
+{
+   if(parentCondition != NULL) {
+      lockParents();
+      for(cardinal i = 0;i < Parents;i++) {
+         if(ParentList[i] == parentCondition) {
+            unlockParents();
+            return;
+         }
+      }
+      if(Parents >= ParentCapacity) {
+         LeanCondition** parentList = new LeanCondition*[2 * ParentCapacity];
+         for(cardinal i = 0;i < Parents;i++) {
+            parentList[i] = ParentList[i];
+         }
+         if(ParentList != (LeanCondition**)&ParentArray) {
+            delete [] ParentList;
+         }
+         ParentList     = parentList;
+         ParentCapacity = 2 * ParentCapacity;
+      }
+      ParentList[Parents] = parentCondition;
+      __atomic_store_n(&Parents, Parents + 1, __ATOMIC_SEQ_CST);
+
+      // A concurrent signal() may have missed the new parent. Then,
+      // the fired state is already visible here.
+      if(peekFired()) {
+         parentCondition->broadcast();
+      }
+      unlockParents();
+   }
+}
+
+
+// ###### Remove parent condition ###########################################
+void LeanCondition::removeParent(LeanCondition* parentCondition)
+{
+   if(parentCondition != NULL) {
+      lockParents();
+      for(cardinal i = 0;i < Parents;i++) {
+         if(ParentList[i] == parentCondition) {
+            ParentList[i] = ParentList[Parents - 1];
+            __atomic_store_n(&Parents, Parents - 1, __ATOMIC_SEQ_CST);
+            break;
+         }
+      }
+      unlockParents();
+   }
+}
+
+
+// ###### Set fired state, wake up waiters and notify parents ###############
+void LeanCondition::notify(const bool all)
+{
+   // A waiter increments Waiters before it checks the fired state. Then,
+   // either the waiter sees the fired state or the Waiters count is seen
+   // here. If the condition has already been fired, the store is skipped:
+   // like for Condition, firing it again makes no difference.
+   if(!__atomic_load_n(&Fired, __ATOMIC_SEQ_CST)) {
+      __atomic_store_n(&Fired, true, __ATOMIC_SEQ_CST);
+   }
+   if(__atomic_load_n(&Waiters, __ATOMIC_SEQ_CST) > 0) {
+      __atomic_add_fetch(&Sequence, 1, __ATOMIC_SEQ_CST);
+      futexWake(&Sequence, all);
+   }
+
+   // The parent list is locked during the notification, in order to
+   // let removeParent() wait until the parent is no longer accessed.
+   if(__atomic_load_n(&Parents, __ATOMIC_SEQ_CST) > 0) {
+      lockParents();
+      for(cardinal i = 0;i < Parents;i++) {
+         if(all) {
+            ParentList[i]->broadcast();
+         }
+         else {
+            ParentList[i]->signal();
+         }
+      }
+      unlockParents();
+   }
+}
+
+
+// ###### Fire condition ####################################################
+void LeanCondition::signal()
+{
+   notify(false);
+}
+
+
+// ###### Broadcast condition ###############################################
+void LeanCondition::broadcast()
+{
+   notify(true);
+}
+
+
+// ###### Wait for condition ################################################
+void LeanCondition::wait()
+{
+   while(!timedWait(3600000000ULL)) {
+      sched_yield();
+   }
+}
+
+
+// ###### Wait for condition with timeout ###################################
+bool LeanCondition::timedWait(const card64 microseconds)
+{
+   cardinal oldstate = Thread::setCancelState(Thread::TCS_CancelDisabled);
+
+   bool result = fired();
+   if(!result) {
+      const card64 timeout = getMicroTime() + microseconds;
+      __atomic_add_fetch(&Waiters, 1, __ATOMIC_SEQ_CST);
+      for(;;) {
+         // If the condition is fired after reading the sequence number,
+         // the sequence number is changed by notify() and the futex wait
+         // returns immediately.
+         const card32 sequence = __atomic_load_n(&Sequence, __ATOMIC_SEQ_CST);
+         if(fired()) {
+            result = true;
+            break;
+         }
+         const card64 now = getMicroTime();
+         if(now >= timeout) {
+            break;
+         }
+         futexWait(&Sequence, sequence, timeout - now);
+         if(__atomic_load_n(&Sequence, __ATOMIC_SEQ_CST) != sequence) {
+            // Like a broadcast on a pthread condition variable, a
+            // broadcast() resumes all waiting threads. Only the first one
+            // finds the fired state set.
+            fired();
+            result = true;
+            break;
+         }
+      }
+      __atomic_sub_fetch(&Waiters, 1, __ATOMIC_SEQ_CST);
+   }
+
+   Thread::setCancelState(oldstate);
+   if(oldstate == Thread::TCS_CancelEnabled) {
+      pthread_testcancel();
+   }
+   return(result);
+}
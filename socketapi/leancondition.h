@@ -0,0 +1,163 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Lean Condition
+ *
+ */
+
+
+#ifndef LEANCONDITION_H
+#define LEANCONDITION_H
+
+
+#include "tdsystem.h"
+
+
+
+/**
+  * This class realizes a lightweight condition variable. In contrast to
+  * Condition, it has neither a mutex nor a name nor a pthread condition
+  * variable: the fired state is a flag, and waiting threads sleep on an
+  * event counter (a futex on Linux). The first parent conditions are
+  * stored within the object itself. Signalling a condition which has no
+  * waiters and no parents only requires a few atomic operations. The
+  * fired state and parent propagation have the same semantics as for
+  * Condition, which is itself based on this class.
+  *
+  * @short   Lean Condition
+  * @author  Thomas Dreibholz (thomas.dreibholz@gmail.com)
+  * @version 1.0
+  * @see Condition
+*/
+class LeanCondition
+{
+   // ====== Constructor/Destructor =========================================
+   public:
+   /**
+     * Constructor.
+     *
+     * @param parentCondition Parent condition.
+     */
+   LeanCondition(LeanCondition* parentCondition = NULL);
+
+   /**
+     * Destructor.
+     */
+   virtual ~LeanCondition();
+
+
+   // ====== Condition variable functions ===================================
+   /**
+     * Fire condition: One thread waiting for this variable will be
+     * resumed. Subclasses may override this method to be notified when
+     * a child condition fires.
+     */
+   virtual void signal();
+
+   /**
+     * Broadcast condition: All threads waiting for this variable will be
+     * resumed. Subclasses may override this method to be notified when
+     * a child condition fires.
+     */
+   virtual void broadcast();
+
+   /**
+     * Check, if condition has been fired. This call will reset
+     * the fired state.
+     *
+     * @return true, if condition has been fired; false otherwise.
+     */
+   inline bool fired();
+
+   /**
+     * Check, if condition has been fired. This call will *not*
+     * reset the fired state.
+     *
+     * @return true, if condition has been fired; false otherwise.
+     */
+   inline bool peekFired();
+
+   /**
+     * Wait for condition without timeout.
+     */
+   void wait();
+
+   /**
+     * Wait for condition with timeout.
+     *
+     * @param microseconds Timeout in microseconds.
+     * @return true, if condition has been received; false for timeout.
+     */
+   bool timedWait(const card64 microseconds);
+
+
+   // ====== Parent condition management ====================================
+   /**
+     * Add parent condition.
+     *
+     * @param parentCondition Parent condition to be added.
+     */
+   void addParent(LeanCondition* parentCondition);
+
+   /**
+     * Remove parent condition. After this call has returned, the parent
+     * condition is not accessed by a concurrent signal() or broadcast()
+     * any more and may be destroyed.
+     *
+     * @param parentCondition Parent condition to be removed.
+     */
+   void removeParent(LeanCondition* parentCondition);
+
+
+   // ====== Private data ===================================================
+   private:
+   void notify(const bool all);
+   void lockParents();
+   void unlockParents();
+
+   static const cardinal InlineParents = 3;
+
+   card32          Sequence;         // Event counter; waiters sleep on it
+   card32          Waiters;
+   card32          ParentLock;       // 0 = free, 1 = locked, 2 = contended
+   bool            Fired;
+   card16          Parents;
+   card16          ParentCapacity;
+   LeanCondition** ParentList;       // ParentArray or allocated array
+   LeanCondition*  ParentArray[InlineParents];
+};
+
+
+#include "leancondition.icc"
+
+
+#endif
@@ -0,0 +1,192 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: SCTP Address Index
+ *
+ */
+
+
+#include "tdsystem.h"
+#include "sctpaddressindex.h"
+
+
+#include <netinet/in.h>
+
+
+
+// ###### Constructor #######################################################
+SCTPAddressIndex::SCTPAddressIndex(const cardinal initialSize)
+{
+   Table   = NULL;
+   Size    = 0;
+   Shift   = 32;
+   Entries = 0;
+   if(!resize(initialSize)) {
+#ifndef DISABLE_WARNINGS
+      std::cerr << "ERROR: SCTPAddressIndex::SCTPAddressIndex() - Out of memory!" << std::endl;
+#endif
+      ::abort();
+   }
+}
+
+
+// ###### Destructor ########################################################
+SCTPAddressIndex::~SCTPAddressIndex()
+{
+   delete [] Table;
+   Table   = NULL;
+   Size    = 0;
+   Entries = 0;
+}
+
+
+// ###### Get key for address ###############################################
+bool SCTPAddressIndex::getKey(const SocketAddress& address, Key& key)
+{
+   sockaddr_in6 systemAddress;
+   if(address.getSystemAddress((sockaddr*)&systemAddress, sizeof(systemAddress),
+                               AF_INET6) == 0) {
+      return(false);
+   }
+   memcpy((char*)&key.Address, (const char*)&systemAddress.sin6_addr,
+          sizeof(key.Address));
+   key.Port = systemAddress.sin6_port;
+   return(true);
+}
+
+
+// ###### Resize table ######################################################
+bool SCTPAddressIndex::resize(const cardinal newSize)
+{
+   cardinal size  = 16;
+   cardinal shift = 28;
+   while(size < newSize) {
+      size <<= 1;
+      shift--;
+   }
+
+   Entry* table = new Entry[size];
+   if(table == NULL) {
+      return(false);
+   }
+   for(cardinal i = 0;i < size;i++) {
+      table[i].Association = NULL;
+   }
+
+   Entry*         oldTable = Table;
+   const cardinal oldSize  = Size;
+   Table = table;
+   Size  = size;
+   Shift = shift;
+   for(cardinal i = 0;i < oldSize;i++) {
+      if(oldTable[i].Association != NULL) {
+         cardinal slot = getSlot(oldTable[i].IndexKey);
+         while(Table[slot].Association != NULL) {
+            slot = (slot + 1) & (Size - 1);
+         }
+         Table[slot] = oldTable[i];
+      }
+   }
+   delete [] oldTable;
+   return(true);
+}
+
+
+// ###### Add entry #########################################################
+bool SCTPAddressIndex::insert(const Key& key, SCTPAssociation* association)
+{
+   if(association == NULL) {
+      return(false);
+   }
+
+   // ====== Keep load factor below 1/2 =====================================
+   if(2 * (Entries + 1) > Size) {
+      if(!resize(2 * Size)) {
+#ifndef DISABLE_WARNINGS
+         std::cerr << "ERROR: SCTPAddressIndex::insert() - Out of memory!" << std::endl;
+#endif
+         return(false);
+      }
+   }
+
+   // ====== Find slot ======================================================
+   cardinal slot = getSlot(key);
+   while(Table[slot].Association != NULL) {
+      if((Table[slot].Association == association) &&
+         (equals(Table[slot].IndexKey, key))) {
+         return(true);
+      }
+      slot = (slot + 1) & (Size - 1);
+   }
+   Table[slot].IndexKey    = key;
+   Table[slot].Association = association;
+   Entries++;
+   return(true);
+}
+
+
+// ###### Remove entry ######################################################
+bool SCTPAddressIndex::erase(const Key& key, SCTPAssociation* association)
+{
+   // ====== Find entry =====================================================
+   cardinal gap = getSlot(key);
+   for(;;) {
+      if(Table[gap].Association == NULL) {
+         return(false);
+      }
+      if((Table[gap].Association == association) &&
+         (equals(Table[gap].IndexKey, key))) {
+         break;
+      }
+      gap = (gap + 1) & (Size - 1);
+   }
+
+   // ====== Remove by shifting back following entries ======================
+   // See SCTPAssociationTable::erase().
+   cardinal next = gap;
+   for(;;) {
+      next = (next + 1) & (Size - 1);
+      if(Table[next].Association == NULL) {
+         break;
+      }
+      const cardinal home = getSlot(Table[next].IndexKey);
+      const bool     keep = (gap <= next) ? ((gap < home) && (home <= next)) :
+                                            ((gap < home) || (home <= next));
+      if(!keep) {
+         Table[gap] = Table[next];
+         gap        = next;
+      }
+   }
+   Table[gap].Association = NULL;
+   Entries--;
+   return(true);
+}
@@ -0,0 +1,159 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: SCTP Address Index
+ *
+ */
+
+#ifndef SCTPADDRESSINDEX_H
+#define SCTPADDRESSINDEX_H
+
+
+#include "tdsystem.h"
+#include "socketaddress.h"
+
+
+class SCTPAssociation;
+
+
+
+/**
+  * This class is a flat hash table (open addressing with linear probing)
+  * mapping the binary remote address and port of an association's paths
+  * to the SCTPAssociation object. A key may be used by several associations
+  * (e.g. an association in shutdown and its successor). The index is owned
+  * by SCTPSocket and must only be used while holding the SCTPSocketMaster
+  * lock.
+  *
+  * @short   SCTP Address Index
+  * @author  Thomas Dreibholz (thomas.dreibholz@gmail.com)
+  * @version 1.0
+  *
+  * @see SCTPSocket
+  * @see SCTPAssociationTable
+  */
+class SCTPAddressIndex
+{
+   // ====== Constructor/Destructor =========================================
+   public:
+   /**
+     * Constructor.
+     *
+     * @param initialSize Initial number of slots (rounded up to power of 2).
+     */
+   SCTPAddressIndex(const cardinal initialSize = 16);
+
+   /**
+     * Destructor.
+     */
+   ~SCTPAddressIndex();
+
+
+   // ====== Key ============================================================
+   /**
+     * Index key: IPv6 address (IPv4 addresses are IPv4-mapped) and port,
+     * both in network byte order.
+     */
+   struct Key {
+      card8  Address[16];
+      card16 Port;
+   };
+
+   /**
+     * Get key for given address.
+     *
+     * @param address Address.
+     * @param key Reference to store key to.
+     * @return true for success; false, if address is not an internet address.
+     */
+   static bool getKey(const SocketAddress& address, Key& key);
+
+
+   // ====== Index functions ================================================
+   /**
+     * Add entry for given key and association.
+     *
+     * @param key Key.
+     * @param association Association.
+     * @return true for success; false otherwise.
+     */
+   bool insert(const Key& key, SCTPAssociation* association);
+
+   /**
+     * Remove entry for given key and association.
+     *
+     * @param key Key.
+     * @param association Association.
+     * @return true, if entry has been removed; false, if not found.
+     */
+   bool erase(const Key& key, SCTPAssociation* association);
+
+   /**
+     * Find next association for given key. To iterate over all associations
+     * using the key, set position to 0 and call find() until it returns NULL.
+     *
+     * @param key Key.
+     * @param position Reference to probe position (0 to start new search).
+     * @return Association or NULL, if there are no more entries.
+     */
+   inline SCTPAssociation* find(const Key& key, cardinal& position) const;
+
+   /**
+     * Get number of entries.
+     *
+     * @return Number of entries.
+     */
+   inline cardinal count() const;
+
+
+   // ====== Private data ===================================================
+   private:
+   struct Entry {
+      Key              IndexKey;
+      SCTPAssociation* Association;   // NULL for empty slot
+   };
+
+   inline static bool equals(const Key& key1, const Key& key2);
+   inline cardinal getSlot(const Key& key) const;
+   bool resize(const cardinal newSize);
+
+   Entry*   Table;
+   cardinal Size;
+   cardinal Shift;
+   cardinal Entries;
+};
+
+
+#include "sctpaddressindex.icc"
+
+
+#endif
@@ -64,6 +64,7 @@ SCTPAssociation::SCTPAssociation(SCTPSocket*        socket,
    ShutdownCompleteNotification  = false;
    IsShuttingDown                = false;
    UseCount                      = 0;
+   AutoCloseQueued               = false;
    LastUsage                     = getMicroTime();
    NotificationFlags             = notificationFlags;
    Defaults.ProtoID              = 0x00000000;
@@ -77,14 +78,13 @@ SCTPAssociation::SCTPAssociation(SCTPSocket*        socket,
    LastPreEstablishmentPacket    = NULL;
    PreEstablishmentAddressList   = NULL;
    PeeledOff                     = false;
-
-   EstablishCondition.setName("SCTPAssociation::EstablishCondition");
-   ShutdownCompleteCondition.setName("SCTPAssociation::ShutdownCompleteCondition");
-   ReadyForTransmit.setName("SCTPAssociation::ReadyForTransmitCondition");
-   InQueue.getUpdateCondition()->setName("SCTPAssociation::InQueue");
-   ReadUpdateCondition.setName("SCTPAssociation::ReadUpdateCondition");
-   WriteUpdateCondition.setName("SCTPAssociation::WriteUpdateCondition");
-   ExceptUpdateCondition.setName("SCTPAssociation::ExceptUpdateCondition");
+   PathCacheValid                = false;
+   ReceiveRing                   = NULL;
+   UnbufferedArrivals            = 0;
+   RemotePort                    = 0;
+   RemotePaths                   = 0;
+   IndexedKeys                   = 0;
+   EventFD                       = NULL;
 
    InQueue.getUpdateCondition()->addParent(&ReadUpdateCondition);
 
@@ -104,6 +104,7 @@ SCTPAssociation::SCTPAssociation(SCTPSocket*        socket,
 
    SCTPSocketMaster::MasterInstance.lock();
    Socket->AssociationList.insert(std::pair<unsigned int, SCTPAssociation*>(AssociationID,this));
+   SCTPSocketMaster::AssociationTable.insert(AssociationID,Socket,this);
    SCTPSocketMaster::MasterInstance.unlock();
 }
 
@@ -159,11 +160,45 @@ SCTPAssociation::~SCTPAssociation()
       ::abort();
    }
 
+   const SCTPAssociationTable::Entry* entry = SCTPSocketMaster::AssociationTable.find(AssociationID);
+   if((entry != NULL) && (entry->Association == this)) {
+      SCTPSocketMaster::AssociationTable.erase(AssociationID);
+   }
+   unindexAddresses();
+   SCTPSocketMaster::unscheduleAutoClose(this);
+
+   // ====== Remove event descriptor ========================================
+   if(EventFD != NULL) {
+      ReadUpdateCondition.removeParent(EventFD);
+      WriteUpdateCondition.removeParent(EventFD);
+      ExceptUpdateCondition.removeParent(EventFD);
+      delete EventFD;
+      EventFD = NULL;
+   }
+
    // ====== Clear ID, to make finding dangling references easier ===========
    AssociationID = 0;
 
+   // ====== Detach receive ring ===========================================
+   // The association cannot be found by the SCTPSocketMaster thread any
+   // more, so its receive ring is not used by sctplib callbacks now.
+   // Application readers look up the association and use its receive ring
+   // while holding the lock of the queue containing the entry, i.e. InQueue
+   // or the socket's GlobalQueue. Since the association cannot be found any
+   // more, obtaining both queue locks waits until such readers have left.
+   SCTPMessageRing* receiveRing = ReceiveRing;
+   InQueue.synchronized();
+   ReceiveRing = NULL;
+   InQueue.unsynchronized();
+   Socket->GlobalQueue.synchronized();
+   Socket->GlobalQueue.unsynchronized();
+
    SCTPSocketMaster::MasterInstance.unlock();
 
+   if(receiveRing) {
+      delete receiveRing;
+   }
+
    if(StreamDefaultTimeoutArray) {
       delete StreamDefaultTimeoutArray;
       StreamDefaultTimeoutArray = NULL;
@@ -187,6 +222,29 @@ SCTPAssociation::~SCTPAssociation()
 }
 
 
+// ###### Get event descriptor ##############################################
+int SCTPAssociation::getEventFD()
+{
+   SCTPSocketMaster::MasterInstance.lock();
+   if(EventFD == NULL) {
+      EventFD = new EventFDCondition("SCTPAssociation::EventFD");
+      if(EventFD->getFD() < 0) {
+         delete EventFD;
+         EventFD = NULL;
+         SCTPSocketMaster::MasterInstance.unlock();
+         return(-1);
+      }
+      // Adding the parent signals it if a condition has already fired.
+      ReadUpdateCondition.addParent(EventFD);
+      WriteUpdateCondition.addParent(EventFD);
+      ExceptUpdateCondition.addParent(EventFD);
+   }
+   const int fd = EventFD->getFD();
+   SCTPSocketMaster::MasterInstance.unlock();
+   return(fd);
+}
+
+
 // ###### Get local address #################################################
 bool SCTPAssociation::getLocalAddresses(SocketAddress**& addressArray)
 {
@@ -194,64 +252,155 @@ bool SCTPAssociation::getLocalAddresses(SocketAddress**& addressArray)
 }
 
 
-// ###### Get remote address ################################################
-bool SCTPAssociation::getRemoteAddresses(SocketAddress**& addressArray)
+// ###### Update cache of remote paths ######################################
+bool SCTPAssociation::updatePathCache()
 {
-   bool                    result = true;
    SCTP_Association_Status status;
-   int                     ok;
 
-   addressArray = NULL;
    SCTPSocketMaster::MasterInstance.lock();
+   PathCacheValid = false;
+   unindexAddresses();
+   if(sctp_getAssocStatus(AssociationID,&status) != 0) {
+      SCTPSocketMaster::MasterInstance.unlock();
+#ifndef DISABLE_WARNINGS
+      std::cerr << "WARNING: SCTPAssociation::updatePathCache() - sctp_getAssocStatus() failure!"
+                << std::endl;
+#endif
+      return(false);
+   }
 
-   if(sctp_getAssocStatus(AssociationID,&status) == 0) {
+   RemotePort  = status.destPort;
 #if (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE19) || (SCTPLIB_VERSION == SCTPLIB_1_0_0)
-      const unsigned int addresses = status.numberOfAddresses;
+   RemotePaths = std::min((unsigned short)SCTP_MAX_NUM_ADDRESSES,
+                          status.numberOfAddresses);
 #elif (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE20) || (SCTPLIB_VERSION == SCTPLIB_1_3_0)
-      const unsigned int addresses = status.numberOfDestinationPaths;
+   RemotePaths = std::min((unsigned short)SCTP_MAX_NUM_ADDRESSES,
+                          status.numberOfDestinationPaths);
 #else
 #error Wrong sctplib version!
 #endif
-      addressArray = SocketAddress::newAddressList(addresses);
-      if(addressArray == NULL) {
-         return(false);
-      }
-      unsigned int i;
-      for(i = 0;i < addresses;i++) {
+   for(unsigned int i = 0;i < RemotePaths;i++) {
 #if (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE19) || (SCTPLIB_VERSION == SCTPLIB_1_0_0)
-         const int index = i;
+      RemotePathID[i] = i;
 #elif (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE20) || (SCTPLIB_VERSION == SCTPLIB_1_3_0)
-         const int index = status.destinationPathIDs[i];
+      RemotePathID[i] = status.destinationPathIDs[i];
 #else
 #error Wrong sctplib version!
 #endif
-
-         SCTP_Path_Status pathStatus;
-         ok = sctp_getPathStatus(AssociationID, index, &pathStatus);
-         if(ok != SCTP_SUCCESS) {
+      SCTP_Path_Status pathStatus;
+      const int ok = sctp_getPathStatus(AssociationID,RemotePathID[i],&pathStatus);
+      if(ok != SCTP_SUCCESS) {
 #ifndef DISABLE_WARNINGS
-            std::cerr << "WARNING: SCTPAssociation::getRemoteAddress() - sctp_getPathStatus() failure!" << std::endl
-                      << "return code: " << ok << std::endl;
+         std::cerr << "WARNING: SCTPAssociation::updatePathCache() - sctp_getPathStatus() failure!" << std::endl
+                   << "return code: " << ok << std::endl;
 #endif
-            SocketAddress::deleteAddressList(addressArray);
-            result = false;
+         RemotePathAddress[i][0]          = 0x00;
+         RemotePathSystemAddressLength[i] = 0;
+      }
+      else {
+         memcpy((char*)&RemotePathAddress[i],
+                (char*)&pathStatus.destinationAddress,
+                sizeof(RemotePathAddress[i]));
+         RemotePathAddress[i][SCTP_MAX_IP_LEN - 1] = 0x00;
+
+         // ====== Convert address to sockaddr of socket's family ===========
+         RemotePathSystemAddressLength[i] = 0;
+         SocketAddress* address = SocketAddress::createSocketAddress(
+                                     0, (char*)&RemotePathAddress[i], RemotePort);
+         if(address != NULL) {
+            RemotePathSystemAddressLength[i] = address->getSystemAddress(
+                                                  (sockaddr*)&RemotePathSystemAddress[i],
+                                                  sizeof(RemotePathSystemAddress[i]),
+                                                  Socket->Family);
+            indexAddress(*address);
+            delete address;
+         }
+      }
+   }
+   PathCacheValid = true;
+
+   SCTPSocketMaster::MasterInstance.unlock();
+   return(true);
+}
+
+
+// ###### Add address to socket's address index ############################
+// The SCTPSocketMaster lock must be held.
+void SCTPAssociation::indexAddress(const SocketAddress& address)
+{
+   if(IndexedKeys < SCTP_MAX_NUM_ADDRESSES) {
+      if( (SCTPAddressIndex::getKey(address, IndexedKey[IndexedKeys])) &&
+          (Socket->AddressIndex.insert(IndexedKey[IndexedKeys], this)) ) {
+         IndexedKeys++;
+      }
+   }
+}
+
+
+// ###### Remove all addresses from socket's address index ##################
+// The SCTPSocketMaster lock must be held.
+void SCTPAssociation::unindexAddresses()
+{
+   for(cardinal i = 0;i < IndexedKeys;i++) {
+      Socket->AddressIndex.erase(IndexedKey[i], this);
+   }
+   IndexedKeys = 0;
+}
+
+
+// ###### Get cached sockaddr of remote path ###############################
+// The SCTPSocketMaster lock must be held, since the cache is updated by the
+// sctplib callbacks.
+const sockaddr* SCTPAssociation::getPathSystemAddress(const unsigned int pathID,
+                                                      socklen_t&         addressLength)
+{
+   if((PathCacheValid) || (updatePathCache())) {
+      for(unsigned int i = 0;i < RemotePaths;i++) {
+         if(RemotePathID[i] == pathID) {
+            addressLength = RemotePathSystemAddressLength[i];
+            if(addressLength > 0) {
+               return((const sockaddr*)&RemotePathSystemAddress[i]);
+            }
             break;
          }
-         else {
-            addressArray[i] = SocketAddress::createSocketAddress(
-                                 0, (char*)&pathStatus.destinationAddress,status.destPort);
-            if(addressArray[i] == NULL) {
+      }
+   }
+   addressLength = 0;
+   return(NULL);
+}
+
+
+// ###### Get remote address ################################################
+bool SCTPAssociation::getRemoteAddresses(SocketAddress**& addressArray)
+{
+   bool result = true;
+
+   addressArray = NULL;
+   SCTPSocketMaster::MasterInstance.lock();
+
+   if((PathCacheValid) || (updatePathCache())) {
+      addressArray = SocketAddress::newAddressList(RemotePaths);
+      if(addressArray == NULL) {
+         SCTPSocketMaster::MasterInstance.unlock();
+         return(false);
+      }
+      for(unsigned int i = 0;i < RemotePaths;i++) {
+         addressArray[i] = SocketAddress::createSocketAddress(
+                              0, (char*)&RemotePathAddress[i], RemotePort);
+         if(addressArray[i] == NULL) {
 #ifndef DISABLE_WARNINGS
-               std::cerr << "WARNING: SCTPAssociation::getRemoteAddresses() - Bad address "
-                         << pathStatus.destinationAddress << ", port " << status.destPort << "!" << std::endl;
+            std::cerr << "WARNING: SCTPAssociation::getRemoteAddresses() - Bad address "
+                      << RemotePathAddress[i] << ", port " << RemotePort << "!" << std::endl;
 #endif
-               SocketAddress::deleteAddressList(addressArray);
-               result = false;
-               break;
-            }
+            SocketAddress::deleteAddressList(addressArray);
+            result = false;
+            break;
          }
       }
    }
+   else {
+      result = false;
+   }
 
    SCTPSocketMaster::MasterInstance.unlock();
    return(result);
@@ -261,10 +410,7 @@ bool SCTPAssociation::getRemoteAddresses(SocketAddress**& addressArray)
 // ###### Check, if socket has data for given flags #########################
 bool SCTPAssociation::hasData()
 {
-   SCTPSocketMaster::MasterInstance.lock();
-   const bool result = InQueue.hasData(NotificationFlags);
-   SCTPSocketMaster::MasterInstance.unlock();
-   return(result);
+   return(InQueue.hasData(NotificationFlags));
 }
 
 
@@ -276,17 +422,35 @@ int SCTPAssociation::receive(char*           buffer,
                              unsigned int&   protoID,
                              uint16_t&       ssn,
                              uint32_t&       tsn)
+{
+   const struct iovec iov = { buffer, bufferSize };
+   return(receive(&iov, 1, bufferSize,
+                  flags,
+                  streamID, protoID,
+                  ssn, tsn));
+}
+
+
+// ###### Receive into scatter list ##########################################
+int SCTPAssociation::receive(const struct iovec* iov,
+                             const size_t        iovlen,
+                             size_t&             bufferSize,
+                             int&                flags,
+                             unsigned short&     streamID,
+                             unsigned int&       protoID,
+                             uint16_t&           ssn,
+                             uint32_t&           tsn)
 {
    // ====== Receive data ===================================================
    unsigned int assocID = AssociationID;
    streamID             = (unsigned short)-1;
 
    const int result = Socket->internalReceive(InQueue,
-                                              buffer, bufferSize,
+                                              iov, iovlen, bufferSize,
                                               flags,
                                               assocID, streamID, protoID,
                                               ssn, tsn,
-                                              NULL,
+                                              NULL, NULL, NULL,
                                               NotificationFlags);
    return(result);
 }
@@ -303,14 +467,15 @@ int SCTPAssociation::receiveFrom(char*           buffer,
                                  SocketAddress** address)
 {
    // ====== Receive data ===================================================
-   unsigned int assocID = AssociationID;
-   streamID             = (unsigned short)-1;
+   const struct iovec iov     = { buffer, bufferSize };
+   unsigned int       assocID = AssociationID;
+   streamID                   = (unsigned short)-1;
    const int result = Socket->internalReceive(InQueue,
-                                              buffer, bufferSize,
+                                              &iov, 1, bufferSize,
                                               flags,
                                               assocID, streamID, protoID,
                                               ssn, tsn,
-                                              address,
+                                              address, NULL, NULL,
                                               NotificationFlags);
    return(result);
 }
@@ -40,11 +40,15 @@
 
 #include "tdsystem.h"
 #include "condition.h"
+#include "eventfdcondition.h"
 #include "internetaddress.h"
 #include "sctpsocket.h"
 #include "sctpnotificationqueue.h"
+#include "sctpmessagering.h"
+#include "sctpaddressindex.h"
 
 #include <sctp.h>
+#include <map>
 
 
 class SCTPSocket;
@@ -178,6 +182,29 @@ class SCTPAssociation
                    uint32_t&       tsn,
                    SocketAddress** address);
 
+   /**
+     * Receive data into a scatter list. All buffers are filled from one
+     * message in a single pass.
+     *
+     * @param iov Buffers to store data to.
+     * @param iovlen Number of buffers.
+     * @param bufferSize Variable to store actual size of data content to.
+     * @param flags Flags; this will be overwritten with actual reception flags.
+     * @param streamID Variable to store stream ID to.
+     * @param protoID Variable to store protocol ID to.
+     * @param ssn Variable to store SSN to.
+     * @param tsn Variable to store TSN to.
+     * @return error code (0 for success).
+     */
+   int receive(const struct iovec* iov,
+               const size_t        iovlen,
+               size_t&             bufferSize,
+               int&                flags,
+               unsigned short&     streamID,
+               unsigned int&       protoID,
+               uint16_t&           ssn,
+               uint32_t&           tsn);
+
 
    /**
      * Send data.
@@ -422,7 +449,41 @@ class SCTPAssociation
      * @param type Update condition type.
      * @return Update condition.
      */
-   inline Condition* getUpdateCondition(const UpdateConditionType type);
+   inline LeanCondition* getUpdateCondition(const UpdateConditionType type);
+
+   /**
+     * Check readiness state for given update condition type, without
+     * firing the update condition.
+     *
+     * @param type Update condition type.
+     * @return true, if ready; false otherwise.
+     */
+   inline bool isReady(const UpdateConditionType type) const;
+
+   /**
+     * Check, if the association has been closed, i.e. its shutdown is
+     * complete or the communication has been lost.
+     *
+     * @return true, if closed; false otherwise.
+     */
+   inline bool isClosed() const;
+
+   /**
+     * Check, if the communication of the association has been lost.
+     *
+     * @return true, if aborted; false otherwise.
+     */
+   inline bool isAborted() const;
+
+   /**
+     * Get event descriptor, which becomes readable on updates of the
+     * read, write and exception conditions of this association. It is created
+     * on first usage and belongs to the association. The application has to
+     * read it to reset it.
+     *
+     * @return Event descriptor or -1 in case of error.
+     */
+   int getEventFD();
 
 
    // ====== Protected data =================================================
@@ -436,18 +497,28 @@ class SCTPAssociation
    // ====== Private data ===================================================
    private:
    bool sendPreEstablishmentPackets();
+   bool updatePathCache();
+   const sockaddr* getPathSystemAddress(const unsigned int pathID,
+                                        socklen_t&         addressLength);
+   void indexAddress(const SocketAddress& address);
+   void unindexAddresses();
 
    SCTPSocket*           Socket;
    SCTPNotificationQueue InQueue;
-   Condition             EstablishCondition;
-   Condition             ShutdownCompleteCondition;
-   Condition             ReadyForTransmit;
-   Condition             ReadUpdateCondition;
-   Condition             WriteUpdateCondition;
-   Condition             ExceptUpdateCondition;
+   SCTPMessageRing*      ReceiveRing;
+   cardinal              UnbufferedArrivals;
+   LeanCondition         EstablishCondition;
+   LeanCondition         ShutdownCompleteCondition;
+   LeanCondition         ReadyForTransmit;
+   LeanCondition         ReadUpdateCondition;
+   LeanCondition         WriteUpdateCondition;
+   LeanCondition         ExceptUpdateCondition;
+   EventFDCondition*     EventFD;
 
    card64                LastUsage;
    cardinal              UseCount;
+   bool                  AutoCloseQueued;
+   std::multimap<card64, SCTPAssociation*>::iterator AutoCloseEntry;
 
    unsigned int          AssociationID;
    unsigned int          NotificationFlags;
@@ -487,6 +558,17 @@ class SCTPAssociation
    SocketAddress**         PreEstablishmentAddressList;
 
    bool                    PeeledOff;
+
+   bool                    PathCacheValid;
+   unsigned short          RemotePort;
+   unsigned short          RemotePaths;
+   unsigned int            RemotePathID[SCTP_MAX_NUM_ADDRESSES];
+   char                    RemotePathAddress[SCTP_MAX_NUM_ADDRESSES][SCTP_MAX_IP_LEN];
+   sockaddr_storage        RemotePathSystemAddress[SCTP_MAX_NUM_ADDRESSES];
+   socklen_t               RemotePathSystemAddressLength[SCTP_MAX_NUM_ADDRESSES];
+
+   cardinal                IndexedKeys;
+   SCTPAddressIndex::Key   IndexedKey[SCTP_MAX_NUM_ADDRESSES];
 };
 
 
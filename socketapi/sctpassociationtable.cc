@@ -0,0 +1,184 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Association Table
+ *
+ */
+
+
+#include "tdsystem.h"
+#include "sctpassociationtable.h"
+
+
+
+// ###### Constructor #######################################################
+SCTPAssociationTable::SCTPAssociationTable(const cardinal initialSize)
+   : Synchronizable("SCTPAssociationTable")
+{
+   Table   = NULL;
+   Size    = 0;
+   Shift   = 32;
+   Entries = 0;
+   if(!resize(initialSize)) {
+#ifndef DISABLE_WARNINGS
+      std::cerr << "ERROR: SCTPAssociationTable::SCTPAssociationTable() - Out of memory!" << std::endl;
+#endif
+      ::abort();
+   }
+}
+
+
+// ###### Destructor ########################################################
+SCTPAssociationTable::~SCTPAssociationTable()
+{
+   delete [] Table;
+   Table   = NULL;
+   Size    = 0;
+   Entries = 0;
+}
+
+
+// ###### Resize table ######################################################
+bool SCTPAssociationTable::resize(const cardinal newSize)
+{
+   cardinal size  = 16;
+   cardinal shift = 28;
+   while(size < newSize) {
+      size <<= 1;
+      shift--;
+   }
+
+   Entry* table = new Entry[size];
+   if(table == NULL) {
+      return(false);
+   }
+   for(cardinal i = 0;i < size;i++) {
+      table[i].AssocID     = 0;
+      table[i].Socket      = NULL;
+      table[i].Association = NULL;
+   }
+
+   Entry*         oldTable = Table;
+   const cardinal oldSize  = Size;
+   Table = table;
+   Size  = size;
+   Shift = shift;
+   for(cardinal i = 0;i < oldSize;i++) {
+      if(oldTable[i].AssocID != 0) {
+         cardinal slot = getSlot(oldTable[i].AssocID);
+         while(Table[slot].AssocID != 0) {
+            slot = (slot + 1) & (Size - 1);
+         }
+         Table[slot] = oldTable[i];
+      }
+   }
+   delete [] oldTable;
+   return(true);
+}
+
+
+// ###### Add or replace entry ##############################################
+bool SCTPAssociationTable::insert(const unsigned int assocID,
+                                  SCTPSocket*        socket,
+                                  SCTPAssociation*   association)
+{
+   if(assocID == 0) {
+      return(false);
+   }
+
+   synchronized();
+
+   // ====== Keep load factor below 1/2 =====================================
+   if(2 * (Entries + 1) > Size) {
+      if(!resize(2 * Size)) {
+#ifndef DISABLE_WARNINGS
+         std::cerr << "ERROR: SCTPAssociationTable::insert() - Out of memory!" << std::endl;
+#endif
+         unsynchronized();
+         return(false);
+      }
+   }
+
+   // ====== Find slot ======================================================
+   cardinal slot = getSlot(assocID);
+   while((Table[slot].AssocID != 0) && (Table[slot].AssocID != assocID)) {
+      slot = (slot + 1) & (Size - 1);
+   }
+   if(Table[slot].AssocID == 0) {
+      Entries++;
+   }
+   Table[slot].AssocID     = assocID;
+   Table[slot].Socket      = socket;
+   Table[slot].Association = association;
+
+   unsynchronized();
+   return(true);
+}
+
+
+// ###### Remove entry ######################################################
+bool SCTPAssociationTable::erase(const unsigned int assocID)
+{
+   synchronized();
+   const Entry* entry = find(assocID);
+   if(entry == NULL) {
+      unsynchronized();
+      return(false);
+   }
+
+   // ====== Remove by shifting back following entries ======================
+   // No tombstones are necessary: each following entry of the probe
+   // sequence is moved into the gap, unless its home slot lies between
+   // the gap and its current position.
+   cardinal gap  = entry - Table;
+   cardinal next = gap;
+   for(;;) {
+      next = (next + 1) & (Size - 1);
+      if(Table[next].AssocID == 0) {
+         break;
+      }
+      const cardinal home = getSlot(Table[next].AssocID);
+      const bool     keep = (gap <= next) ? ((gap < home) && (home <= next)) :
+                                            ((gap < home) || (home <= next));
+      if(!keep) {
+         Table[gap] = Table[next];
+         gap        = next;
+      }
+   }
+   Table[gap].AssocID     = 0;
+   Table[gap].Socket      = NULL;
+   Table[gap].Association = NULL;
+   Entries--;
+
+   unsynchronized();
+   return(true);
+}
@@ -0,0 +1,158 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Association Table
+ *
+ */
+
+
+#ifndef SCTPASSOCIATIONTABLE_H
+#define SCTPASSOCIATIONTABLE_H
+
+
+#include "tdsystem.h"
+#include "synchronizable.h"
+
+
+class SCTPSocket;
+class SCTPAssociation;
+
+
+
+/**
+  * This class is a flat hash table (open addressing with linear probing)
+  * mapping an association ID to its SCTPSocket and SCTPAssociation objects.
+  * It is used by SCTPSocketMaster to resolve the association IDs of sctplib
+  * callbacks without tree lookups. Association ID 0 is reserved for empty
+  * slots. insert() and erase() obtain the table lock themselves and are
+  * only called while holding the SCTPSocketMaster lock. Therefore, find()
+  * may be used while holding either the SCTPSocketMaster lock or the table
+  * lock (e.g. by application threads, without contending with sctplib).
+  *
+  * @short   SCTP Association Table
+  * @author  Thomas Dreibholz (thomas.dreibholz@gmail.com)
+  * @version 1.0
+  *
+  * @see SCTPSocketMaster
+  */
+class SCTPAssociationTable : public Synchronizable
+{
+   // ====== Constructor/Destructor =========================================
+   public:
+   /**
+     * Constructor.
+     *
+     * @param initialSize Initial number of slots (rounded up to power of 2).
+     */
+   SCTPAssociationTable(const cardinal initialSize = 64);
+
+   /**
+     * Destructor.
+     */
+   ~SCTPAssociationTable();
+
+
+   // ====== Table entry ====================================================
+   /**
+     * Table entry.
+     */
+   struct Entry {
+      /**
+        * Association ID (0 for empty slot).
+        */
+      unsigned int     AssocID;
+
+      /**
+        * Socket.
+        */
+      SCTPSocket*      Socket;
+
+      /**
+        * Association.
+        */
+      SCTPAssociation* Association;
+   };
+
+
+   // ====== Table functions ================================================
+   /**
+     * Add or replace entry for given association ID.
+     *
+     * @param assocID Association ID.
+     * @param socket Socket.
+     * @param association Association.
+     * @return true for success; false otherwise.
+     */
+   bool insert(const unsigned int assocID,
+               SCTPSocket*        socket,
+               SCTPAssociation*   association);
+
+   /**
+     * Remove entry for given association ID.
+     *
+     * @param assocID Association ID.
+     * @return true, if entry has been removed; false, if not found.
+     */
+   bool erase(const unsigned int assocID);
+
+   /**
+     * Find entry for given association ID.
+     *
+     * @param assocID Association ID.
+     * @return Entry or NULL, if not found.
+     */
+   inline const Entry* find(const unsigned int assocID) const;
+
+   /**
+     * Get number of entries.
+     *
+     * @return Number of entries.
+     */
+   inline cardinal count() const;
+
+
+   // ====== Private data ===================================================
+   private:
+   inline cardinal getSlot(const unsigned int assocID) const;
+   bool resize(const cardinal newSize);
+
+   Entry*   Table;
+   cardinal Size;
+   cardinal Shift;
+   cardinal Entries;
+};
+
+
+#include "sctpassociationtable.icc"
+
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Message Ring Buffer
+ *
+ */
+
+
+#include "tdsystem.h"
+#include "sctpmessagering.h"
+
+
+
+// ###### Constructor #######################################################
+SCTPMessageRing::SCTPMessageRing(const cardinal size)
+   : Synchronizable("SCTPMessageRing")
+{
+   Buffer = new char[size];
+   if(Buffer == NULL) {
+#ifndef DISABLE_WARNINGS
+      std::cerr << "ERROR: SCTPMessageRing::SCTPMessageRing() - Out of memory!" << std::endl;
+#endif
+      Size = 0;
+   }
+   else {
+      Size = size;
+   }
+   Head             = 0;
+   Tail             = 0;
+   End              = 0;
+   Messages         = 0;
+   ReservedPosition = 0;
+   Wrapped          = false;
+   ReservedWrap     = false;
+}
+
+
+// ###### Destructor ########################################################
+SCTPMessageRing::~SCTPMessageRing()
+{
+   delete [] Buffer;
+   Buffer   = NULL;
+   Size     = 0;
+   Messages = 0;
+}
+
+
+// ###### Reserve space for new message #####################################
+char* SCTPMessageRing::reserve(const cardinal length)
+{
+   const cardinal recordSize = getRecordSize(length);
+   char*          data       = NULL;
+
+   synchronized();
+   if(Messages == 0) {
+      Head    = 0;
+      Tail    = 0;
+      Wrapped = false;
+   }
+
+   // ====== Ring is not wrapped: append or wrap around =====================
+   if(!Wrapped) {
+      if(Size - Tail >= recordSize) {
+         ReservedPosition = Tail;
+         ReservedWrap     = false;
+         data             = &Buffer[ReservedPosition + sizeof(Record)];
+      }
+      else if(Head >= recordSize) {
+         ReservedPosition = 0;
+         ReservedWrap     = true;
+         data             = &Buffer[ReservedPosition + sizeof(Record)];
+      }
+   }
+
+   // ====== Ring is wrapped: append in front of head =======================
+   else {
+      if(Head - Tail >= recordSize) {
+         ReservedPosition = Tail;
+         ReservedWrap     = false;
+         data             = &Buffer[ReservedPosition + sizeof(Record)];
+      }
+   }
+   unsynchronized();
+
+   return(data);
+}
+
+
+// ###### Append reserved message ###########################################
+void SCTPMessageRing::commit(const Record& record)
+{
+   synchronized();
+   memcpy(&Buffer[ReservedPosition], &record, sizeof(Record));
+   if(ReservedWrap) {
+      // The reader may have emptied the ring in the meantime.
+      if(Messages == 0) {
+         Head = 0;
+      }
+      else {
+         End     = Tail;
+         Wrapped = true;
+      }
+   }
+   Tail = ReservedPosition + getRecordSize(record.Length);
+   Messages++;
+   unsynchronized();
+}
+
+
+// ###### Copy data of message on head of ring ##############################
+bool SCTPMessageRing::read(const cardinal      remaining,
+                           const struct iovec* iov,
+                           const size_t        iovlen,
+                           size_t&             bufferSize,
+                           Record&             record)
+{
+   bufferSize = 0;
+   synchronized();
+   if(Messages == 0) {
+      unsynchronized();
+      return(false);
+   }
+
+   memcpy(&record, &Buffer[Head], sizeof(Record));
+   const size_t available = std::min(remaining, record.Length);
+   const char*  data      = &Buffer[Head + sizeof(Record) + (record.Length - available)];
+   for(size_t i = 0;(i < iovlen) && (bufferSize < available);i++) {
+      const size_t toCopy = std::min(iov[i].iov_len, available - bufferSize);
+      memcpy(iov[i].iov_base, &data[bufferSize], toCopy);
+      bufferSize += toCopy;
+   }
+   unsynchronized();
+   return(true);
+}
+
+
+// ###### Drop message on head of ring ######################################
+void SCTPMessageRing::drop()
+{
+   synchronized();
+   if(Messages > 0) {
+      const Record* record = (const Record*)&Buffer[Head];
+      Head += getRecordSize(record->Length);
+      Messages--;
+      if((Wrapped) && (Head == End)) {
+         Head    = 0;
+         Wrapped = false;
+      }
+   }
+   unsynchronized();
+}
@@ -0,0 +1,197 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Message Ring Buffer
+ *
+ */
+
+
+#ifndef SCTPMESSAGERING_H
+#define SCTPMESSAGERING_H
+
+
+#include "tdsystem.h"
+#include "synchronizable.h"
+
+#include <sctp.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+
+
+
+/**
+  * This class is a ring buffer for received messages of an association.
+  * In eager receive mode, the SCTPSocketMaster thread copies each arriving
+  * message from sctplib into the ring; application threads complete their
+  * receive calls from the ring, without calling sctplib and therefore
+  * without obtaining the SCTPSocketMaster lock. Each message is stored
+  * contiguously: the writer reserves space by reserve(), fills it and
+  * appends the message by commit(). There is exactly one writer (the
+  * SCTPSocketMaster thread). The ring lock is a leaf in the lock hierarchy.
+  *
+  * @short   SCTP Message Ring
+  * @author  Thomas Dreibholz (thomas.dreibholz@gmail.com)
+  * @version 1.0
+  *
+  * @see SCTPAssociation
+  * @see SCTPSocketMaster
+  */
+class SCTPMessageRing : public Synchronizable
+{
+   // ====== Constructor/Destructor =========================================
+   public:
+   /**
+     * Constructor.
+     *
+     * @param size Ring buffer size in bytes.
+     */
+   SCTPMessageRing(const cardinal size);
+
+   /**
+     * Destructor.
+     */
+   ~SCTPMessageRing();
+
+
+   // ====== Message record =================================================
+   /**
+     * Message record header. The message data follows the header.
+     */
+   struct Record {
+      /**
+        * Message length in bytes.
+        */
+      cardinal       Length;
+
+      /**
+        * Stream ID.
+        */
+      unsigned short StreamID;
+
+      /**
+        * Stream sequence number.
+        */
+      uint16_t       SSN;
+
+      /**
+        * Transmission sequence number.
+        */
+      uint32_t       TSN;
+
+      /**
+        * Length of remote address (0 if unknown).
+        */
+      socklen_t      RemoteAddressLength;
+
+      /**
+        * Remote address the message has been received from, as sockaddr_in
+        * or sockaddr_in6 in the socket's address family.
+        */
+      sockaddr_in6   RemoteAddress;
+   };
+
+
+   // ====== Writer functions ===============================================
+   /**
+     * Reserve space for a new message. The reservation is valid until the
+     * next call of reserve() or commit().
+     *
+     * @param length Message length in bytes.
+     * @return Pointer to message data space or NULL, if there is no space.
+     */
+   char* reserve(const cardinal length);
+
+   /**
+     * Append reserved message to the ring.
+     *
+     * @param record Record header (Length must not exceed reservation).
+     */
+   void commit(const Record& record);
+
+
+   // ====== Reader functions ===============================================
+   /**
+     * Copy data of message on head of ring into a scatter list.
+     *
+     * @param remaining Number of message bytes not read yet; data is copied from offset (message length - remaining).
+     * @param iov Buffers to copy data to.
+     * @param iovlen Number of buffers.
+     * @param bufferSize Reference to store number of bytes copied to.
+     * @param record Reference to store record header to.
+     * @return true for success; false, if ring is empty.
+     */
+   bool read(const cardinal      remaining,
+             const struct iovec* iov,
+             const size_t        iovlen,
+             size_t&             bufferSize,
+             Record&             record);
+
+   /**
+     * Drop message on head of ring.
+     */
+   void drop();
+
+   /**
+     * Get number of messages in ring.
+     *
+     * @return Number of messages.
+     */
+   inline cardinal count();
+
+   /**
+     * Get ring buffer size.
+     *
+     * @return Size in bytes.
+     */
+   inline cardinal getSize() const;
+
+
+   // ====== Private data ===================================================
+   private:
+   inline static cardinal getRecordSize(const cardinal length);
+
+   char*    Buffer;
+   cardinal Size;
+   cardinal Head;
+   cardinal Tail;
+   cardinal End;
+   cardinal Messages;
+   cardinal ReservedPosition;
+   bool     Wrapped;
+   bool     ReservedWrap;
+};
+
+
+#include "sctpmessagering.icc"
+
+
+#endif
@@ -0,0 +1,210 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Notification Queue Entry Pool
+ *
+ */
+
+
+#include "tdsystem.h"
+#include "sctpnotificationpool.h"
+
+
+
+// ###### Constructor #######################################################
+SCTPNotificationPool::SCTPNotificationPool(const cardinal entries,
+                                           const cardinal notifications)
+   : Synchronizable("SCTPNotificationPool", false)
+{
+   FreeEntryList                          = NULL;
+   FreeNotificationList                   = NULL;
+   PoolEntries                            = 0;
+   PoolNotifications                      = 0;
+   PoolStatistics.EntryRequests           = 0;
+   PoolStatistics.EntryAllocations        = 0;
+   PoolStatistics.NotificationRequests    = 0;
+   PoolStatistics.NotificationAllocations = 0;
+   PoolStatistics.FreeEntries             = 0;
+   PoolStatistics.FreeNotifications       = 0;
+   setPoolSize(entries,notifications);
+}
+
+
+// ###### Destructor ########################################################
+SCTPNotificationPool::~SCTPNotificationPool()
+{
+   synchronized();
+   PoolEntries       = 0;
+   PoolNotifications = 0;
+   trimPool();
+   unsynchronized();
+}
+
+
+// ###### Set pool depths ###################################################
+void SCTPNotificationPool::setPoolSize(const cardinal entries,
+                                       const cardinal notifications)
+{
+   synchronized();
+   PoolEntries       = entries;
+   PoolNotifications = notifications;
+
+   // ====== Preallocate entries and notifications ==========================
+   while(PoolStatistics.FreeEntries < PoolEntries) {
+      SCTPNotificationEntry* entry = new SCTPNotificationEntry;
+      if(entry == NULL) {
+         break;
+      }
+      PoolStatistics.EntryAllocations++;
+      entry->NextEntry = FreeEntryList;
+      FreeEntryList    = entry;
+      PoolStatistics.FreeEntries++;
+   }
+   while(PoolStatistics.FreeNotifications < PoolNotifications) {
+      NotificationSlot* slot = new NotificationSlot;
+      if(slot == NULL) {
+         break;
+      }
+      PoolStatistics.NotificationAllocations++;
+      slot->NextSlot       = FreeNotificationList;
+      FreeNotificationList = slot;
+      PoolStatistics.FreeNotifications++;
+   }
+
+   // ====== Release surplus ================================================
+   trimPool();
+   unsynchronized();
+}
+
+
+// ###### Release free entries and notifications exceeding pool depths #####
+void SCTPNotificationPool::trimPool()
+{
+   while(PoolStatistics.FreeEntries > PoolEntries) {
+      SCTPNotificationEntry* entry = FreeEntryList;
+      FreeEntryList = entry->NextEntry;
+      delete entry;
+      PoolStatistics.FreeEntries--;
+   }
+   while(PoolStatistics.FreeNotifications > PoolNotifications) {
+      NotificationSlot* slot = FreeNotificationList;
+      FreeNotificationList = slot->NextSlot;
+      delete slot;
+      PoolStatistics.FreeNotifications--;
+   }
+}
+
+
+// ###### Get new entry #####################################################
+SCTPNotificationEntry* SCTPNotificationPool::newEntry()
+{
+   SCTPNotificationEntry* entry;
+
+   synchronized();
+   PoolStatistics.EntryRequests++;
+   if(FreeEntryList != NULL) {
+      entry         = FreeEntryList;
+      FreeEntryList = entry->NextEntry;
+      PoolStatistics.FreeEntries--;
+   }
+   else {
+      entry = new SCTPNotificationEntry;
+      if(entry != NULL) {
+         PoolStatistics.EntryAllocations++;
+      }
+   }
+   unsynchronized();
+
+   return(entry);
+}
+
+
+// ###### Release entry #####################################################
+void SCTPNotificationPool::deleteEntry(SCTPNotificationEntry* entry)
+{
+   synchronized();
+   if(PoolStatistics.FreeEntries < PoolEntries) {
+      entry->NextEntry = FreeEntryList;
+      FreeEntryList    = entry;
+      PoolStatistics.FreeEntries++;
+   }
+   else {
+      delete entry;
+   }
+   unsynchronized();
+}
+
+
+// ###### Get new notification ##############################################
+SCTPNotification* SCTPNotificationPool::newNotification()
+{
+   NotificationSlot* slot;
+
+   synchronized();
+   PoolStatistics.NotificationRequests++;
+   if(FreeNotificationList != NULL) {
+      slot                 = FreeNotificationList;
+      FreeNotificationList = slot->NextSlot;
+      PoolStatistics.FreeNotifications--;
+   }
+   else {
+      slot = new NotificationSlot;
+      if(slot != NULL) {
+         PoolStatistics.NotificationAllocations++;
+      }
+   }
+   unsynchronized();
+
+   if(slot != NULL) {
+      return(&slot->Notification);
+   }
+   return(NULL);
+}
+
+
+// ###### Release notification ##############################################
+void SCTPNotificationPool::deleteNotification(SCTPNotification* notification)
+{
+   if(notification != NULL) {
+      NotificationSlot* slot = (NotificationSlot*)notification;
+      synchronized();
+      if(PoolStatistics.FreeNotifications < PoolNotifications) {
+         slot->NextSlot       = FreeNotificationList;
+         FreeNotificationList = slot;
+         PoolStatistics.FreeNotifications++;
+      }
+      else {
+         delete slot;
+      }
+      unsynchronized();
+   }
+}
@@ -0,0 +1,193 @@
+/*
+ *
+ * SocketAPI implementation for the sctplib.
+ * Copyright (C) 1999-2026 by Thomas Dreibholz
+ *
+ * Realized in co-operation between
+ * - Siemens AG
+ * - University of Duisburg-Essen, Institute for Experimental Mathematics
+ * - Münster University of Applied Sciences, Burgsteinfurt
+ *
+ * Acknowledgement
+ * This work was partially funded by the Bundesministerium fuer Bildung und
+ * Forschung (BMBF) of the Federal Republic of Germany (Foerderkennzeichen 01AK045).
+ * The authors alone are responsible for the contents.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: discussion@sctp.de
+ *          thomas.dreibholz@gmail.com
+ *          tuexen@fh-muenster.de
+ *
+ * Purpose: Notification Queue Entry Pool
+ *
+ */
+
+
+#ifndef SCTPNOTIFICATIONPOOL_H
+#define SCTPNOTIFICATIONPOOL_H
+
+
+#include "tdsystem.h"
+#include "synchronizable.h"
+#include "sctpnotificationqueue.h"
+
+
+
+/**
+  * This class is a free-list allocator for the entries and notifications
+  * of SCTPNotificationQueue. A configurable number of entries and
+  * notifications is preallocated; released ones are kept for reuse up to
+  * this depth, so that the queues do not use the system heap in the
+  * common case. The pool's lock is a leaf lock, which is never obtained
+  * recursively. Therefore, it uses a non-recursive mutex.
+  *
+  * @short   SCTP Notification Pool
+  * @author  Thomas Dreibholz (thomas.dreibholz@gmail.com)
+  * @version 1.0
+  *
+  * @see SCTPNotificationQueue
+  */
+class SCTPNotificationPool : public Synchronizable
+{
+   // ====== Constructor/Destructor =========================================
+   public:
+   /**
+     * Constructor.
+     *
+     * @param entries Pool depth for queue entries.
+     * @param notifications Pool depth for notifications.
+     */
+   SCTPNotificationPool(const cardinal entries       = DefaultPoolEntries,
+                        const cardinal notifications = DefaultPoolNotifications);
+
+   /**
+     * Destructor.
+     */
+   ~SCTPNotificationPool();
+
+
+   // ====== Allocation =====================================================
+   /**
+     * Get new queue entry.
+     *
+     * @return Entry or NULL, if out of memory.
+     */
+   SCTPNotificationEntry* newEntry();
+
+   /**
+     * Release queue entry. The entry's notification is not released.
+     *
+     * @param entry Entry.
+     */
+   void deleteEntry(SCTPNotificationEntry* entry);
+
+   /**
+     * Get new notification.
+     *
+     * @return Notification or NULL, if out of memory.
+     */
+   SCTPNotification* newNotification();
+
+   /**
+     * Release notification.
+     *
+     * @param notification Notification (may be NULL).
+     */
+   void deleteNotification(SCTPNotification* notification);
+
+
+   // ====== Pool configuration =============================================
+   /**
+     * Set pool depths. Free entries and notifications are preallocated up
+     * to the given depths; the pool keeps at most this number of released
+     * ones for reuse.
+     *
+     * @param entries Pool depth for queue entries.
+     * @param notifications Pool depth for notifications.
+     */
+   void setPoolSize(const cardinal entries,
+                    const cardinal notifications);
+
+
+   // ====== Statistics =====================================================
+   /**
+     * Allocation statistics.
+     */
+   struct Statistics {
+      /**
+        * Number of newEntry() calls.
+        */
+      card64   EntryRequests;
+
+      /**
+        * Number of entries allocated from the system heap.
+        */
+      card64   EntryAllocations;
+
+      /**
+        * Number of newNotification() calls.
+        */
+      card64   NotificationRequests;
+
+      /**
+        * Number of notifications allocated from the system heap.
+        */
+      card64   NotificationAllocations;
+
+      /**
+        * Number of free entries in pool.
+        */
+      cardinal FreeEntries;
+
+      /**
+        * Number of free notifications in pool.
+        */
+      cardinal FreeNotifications;
+   };
+
+   /**
+     * Get allocation statistics.
+     *
+     * @param statistics Reference to store statistics to.
+     */
+   inline void getStatistics(Statistics& statistics);
+
+
+   // ====== Constants ======================================================
+   static const cardinal DefaultPoolEntries       = 256;
+   static const cardinal DefaultPoolNotifications = 8;
+
+
+   // ====== Private data ===================================================
+   private:
+   union NotificationSlot {
+      NotificationSlot* NextSlot;
+      SCTPNotification  Notification;
+   };
+
+   void trimPool();
+
+   SCTPNotificationEntry* FreeEntryList;
+   NotificationSlot*      FreeNotificationList;
+   cardinal               PoolEntries;
+   cardinal               PoolNotifications;
+   Statistics             PoolStatistics;
+};
+
+
+#include "sctpnotificationpool.icc"
+
+
+#endif
@@ -38,17 +38,23 @@
 
 #include "tdsystem.h"
 #include "sctpnotificationqueue.h"
+#include "sctpnotificationpool.h"
 #include "sctp.h"
 
 
 
 // ###### Constructor #######################################################
 SCTPNotificationQueue::SCTPNotificationQueue()
+   : Synchronizable("SCTPNotificationQueue")
 {
-   UpdateCondition.setName("SCTPNotificationQueue::UpdateCondition");
-   First = NULL;
-   Last  = NULL;
-   Count = 0;
+   First         = NULL;
+   Last          = NULL;
+   Count         = 0;
+   DataArrivals  = 0;
+   PendingEvents = 0;
+   for(cardinal i = 0;i < sizeof(EventCount) / sizeof(EventCount[0]);i++) {
+      EventCount[i] = 0;
+   }
 }
 
 
@@ -59,104 +65,148 @@ SCTPNotificationQueue::~SCTPNotificationQueue()
 }
 
 
-// ###### Add notification to end of queue ##################################
-bool SCTPNotificationQueue::addNotification(const SCTPNotification& notification)
+// ###### Get pool ##########################################################
+SCTPNotificationPool* SCTPNotificationQueue::getPool()
 {
-   SCTPNotification* newNotification = new SCTPNotification;
-   if(newNotification != NULL) {
-      *newNotification = notification;
-      newNotification->NextNotification = NULL;
+   // The pool is never destroyed: the SCTPSocketMaster singleton may still
+   // add notifications (e.g. for aborted associations) while the static
+   // objects are destructed at program exit.
+   static SCTPNotificationPool* pool = new SCTPNotificationPool();
+   return(pool);
+}
+
+
+// ###### Append entry to end of queue #####################################
+void SCTPNotificationQueue::appendEntry(SCTPNotificationEntry* entry)
+{
+   synchronized();
+   entry->NextEntry = NULL;
+   if(Last != NULL) {
+      Last->NextEntry = entry;
+   }
+   Last = entry;
+   if(First == NULL) {
+      First = entry;
+   }
+   Count++;
+   countEntry(entry,true);
+   unsynchronized();
+
+   signal();
+}
 
-      if(Last != NULL) {
-         Last->NextNotification = newNotification;
+
+// ###### Update counters for added or removed entry ########################
+void SCTPNotificationQueue::countEntry(const SCTPNotificationEntry* entry,
+                                       const bool                   added)
+{
+   if(entry->Notification == NULL) {
+      if(added) {
+         DataArrivals++;
       }
-      Last = newNotification;
-      if(First == NULL) {
-         First = newNotification;
+      else {
+         DataArrivals--;
+      }
+   }
+   else {
+      const unsigned int flag = getEventFlag(entry);
+      if(flag != 0) {
+         cardinal index = 0;
+         while((flag >> index) != 1) {
+            index++;
+         }
+         if(added) {
+            EventCount[index]++;
+            PendingEvents |= flag;
+         }
+         else {
+            EventCount[index]--;
+            if(EventCount[index] == 0) {
+               PendingEvents &= ~flag;
+            }
+         }
       }
-      Count++;
-
-      signal();
-      return(true);
    }
-#ifndef DISABLE_WARNINGS
-   std::cerr << "ERROR: SCTPNotificationQueue::addNotification() - Out of memory!" << std::endl;
-#endif
-   return(false);
 }
 
 
-// ###### Get and remove chunk from queue ##################################
-bool SCTPNotificationQueue::getNotification(SCTPNotification& notification)
+// ###### Add notification to end of queue ##################################
+bool SCTPNotificationQueue::addNotification(const SCTPNotification& notification)
 {
-   if(First != NULL) {
-      notification = *First;
-      return(true);
+   SCTPNotificationEntry* newEntry = getPool()->newEntry();
+   if(newEntry != NULL) {
+      newEntry->Notification = getPool()->newNotification();
+      if(newEntry->Notification != NULL) {
+         *newEntry->Notification = notification;
+         newEntry->Buffered      = false;
+         appendEntry(newEntry);
+         return(true);
+      }
+      getPool()->deleteEntry(newEntry);
    }
+#ifndef DISABLE_WARNINGS
+   std::cerr << "ERROR: SCTPNotificationQueue::addNotification() - Out of memory!" << std::endl;
+#endif
    return(false);
 }
 
 
-// ###### Add notification to top of queue ##################################
-void SCTPNotificationQueue::updateNotification(const SCTPNotification& notification)
+// ###### Add data arrival to end of queue ##################################
+bool SCTPNotificationQueue::addDataArrive(const sctp_data_arrive& dataArrive,
+                                          const bool              buffered)
 {
-   if(First != NULL) {
-      SCTPNotification* next = First->NextNotification;
-      *First = notification;
-      First->NextNotification = next;
+   SCTPNotificationEntry* newEntry = getPool()->newEntry();
+   if(newEntry != NULL) {
+      newEntry->Notification = NULL;
+      newEntry->DataArrive   = dataArrive;
+      newEntry->Buffered     = buffered;
+      appendEntry(newEntry);
+      return(true);
    }
-   else {
 #ifndef DISABLE_WARNINGS
-      std::cerr << "ERROR: SCTPNotificationQueue::updateHeadNotification() - Queue is empty!" << std::endl;
+   std::cerr << "ERROR: SCTPNotificationQueue::addDataArrive() - Out of memory!" << std::endl;
 #endif
-   }
+   return(false);
 }
 
 
 // ###### Drop first notification ###########################################
 void SCTPNotificationQueue::dropNotification()
 {
+   synchronized();
    if(First != NULL) {
-      SCTPNotification* next = First->NextNotification;
+      SCTPNotificationEntry* next = First->NextEntry;
       if(Last == First) {
          Last = next;
       }
-      delete First;
+      countEntry(First,false);
+      getPool()->deleteNotification(First->Notification);
+      getPool()->deleteEntry(First);
       First = next;
       Count--;
    }
+   unsynchronized();
 }
 
 
 // ###### Flush all chunks #################################################
 void SCTPNotificationQueue::flush()
 {
-   SCTPNotification* notification = First;
-   while(notification != NULL) {
-      SCTPNotification* next = notification->NextNotification;
-      delete notification;
-      notification = next;
+   synchronized();
+   SCTPNotificationEntry* entry = First;
+   while(entry != NULL) {
+      SCTPNotificationEntry* next = entry->NextEntry;
+      getPool()->deleteNotification(entry->Notification);
+      getPool()->deleteEntry(entry);
+      entry = next;
    }
-   First = NULL;
-   Last  = NULL;
-   Count = 0;
-}
-
-
-// ###### Check, if queue has data to read for given flags ##################
-bool SCTPNotificationQueue::hasData(const unsigned int notificationFlags)
-{
-   SCTPNotification* notification = First;
-   while(notification != NULL) {
-      if( ((notification->Content.sn_header.sn_type == SCTP_DATA_ARRIVE)                                                      ||
-          ((notification->Content.sn_header.sn_type == SCTP_ASSOC_CHANGE)     && (notificationFlags & SCTP_RECVASSOCEVNT))    ||
-          ((notification->Content.sn_header.sn_type == SCTP_PEER_ADDR_CHANGE) && (notificationFlags & SCTP_RECVPADDREVNT))    ||
-          ((notification->Content.sn_header.sn_type == SCTP_REMOTE_ERROR)     && (notificationFlags & SCTP_RECVPEERERR))      ||
-          ((notification->Content.sn_header.sn_type == SCTP_SEND_FAILED)      && (notificationFlags & SCTP_RECVSENDFAILEVNT)) ||
-          ((notification->Content.sn_header.sn_type == SCTP_SHUTDOWN_EVENT)   && (notificationFlags & SCTP_RECVSHUTDOWNEVNT)))) {
-         return(true);
-      }
-      notification = notification->NextNotification;
+   First         = NULL;
+   Last          = NULL;
+   Count         = 0;
+   DataArrivals  = 0;
+   PendingEvents = 0;
+   for(cardinal i = 0;i < sizeof(EventCount) / sizeof(EventCount[0]);i++) {
+      EventCount[i] = 0;
    }
-   return(false);
+   unsynchronized();
 }
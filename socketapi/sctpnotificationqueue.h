@@ -40,6 +40,7 @@
 
 
 #include "tdsystem.h"
+#include "synchronizable.h"
 #include "condition.h"
 #include "ext_socket.h"
 #include <sctp.h>
@@ -66,11 +67,6 @@
   */
 struct SCTPNotification
 {
-   /**
-     * Pointer to next notification.
-     */
-   SCTPNotification* NextNotification;
-
    /**
      * Remote port.
      */
@@ -99,6 +95,45 @@ struct SCTPNotification
 
 
 
+/**
+  * SCTP notification queue entry. Data arrivals, which make up nearly all
+  * entries, are stored in compact form within the entry itself. All other
+  * notifications are stored in a separately allocated SCTPNotification.
+  *
+  * @short   SCTP Notification Queue Entry
+  * @author  Thomas Dreibholz (thomas.dreibholz@gmail.com)
+  * @version 1.0
+  */
+struct SCTPNotificationEntry
+{
+   /**
+     * Pointer to next entry.
+     */
+   SCTPNotificationEntry* NextEntry;
+
+   /**
+     * Notification (NULL for data arrival).
+     */
+   SCTPNotification* Notification;
+
+   /**
+     * Data arrival (only valid if Notification is NULL).
+     */
+   sctp_data_arrive DataArrive;
+
+   /**
+     * Data has already been copied into the association's receive ring
+     * (eager receive mode; only valid if Notification is NULL).
+     */
+   bool Buffered;
+};
+
+
+
+class SCTPNotificationPool;
+
+
+
 /**
   * Update condition types.
   */
@@ -111,13 +146,16 @@ enum UpdateConditionType {
 
 
 /**
-  * This class is a queue for SCTP notifications.
+  * This class is a queue for SCTP notifications. The queue has its own
+  * lock, which is a leaf in the lock hierarchy: it may be obtained while
+  * holding the SCTPSocketMaster lock, but the SCTPSocketMaster lock must
+  * never be obtained while holding the queue lock.
   *
   * @short   SCTP Notification Queue
   * @author  Thomas Dreibholz (thomas.dreibholz@gmail.com)
   * @version 1.0
   */
-class SCTPNotificationQueue
+class SCTPNotificationQueue : public Synchronizable
 {
    // ====== Constructor/Destructor =========================================
    public:
@@ -140,19 +178,22 @@ class SCTPNotificationQueue
    bool addNotification(const SCTPNotification& notification);
 
    /**
-     * Get and remove notification from top of queue.
+     * Add data arrival to tail of queue.
      *
-     * @param notification Reference to store notification to.
-     * @return true, if there was a notification; false, if the queue is empty.
+     * @param dataArrive Data arrival.
+     * @param buffered true, if data is in the association's receive ring.
      */
-   bool getNotification(SCTPNotification& notification);
+   bool addDataArrive(const sctp_data_arrive& dataArrive,
+                      const bool              buffered = false);
 
    /**
-     * Update notification on head of queue.
+     * Get entry on head of queue. The entry remains in the queue until
+     * dropNotification() is called. The caller has to lock the queue by
+     * synchronized() while using the entry; it may be updated in place.
      *
-     * @param notification Notification.
+     * @return Entry or NULL, if the queue is empty.
      */
-   void updateNotification(const SCTPNotification& notification);
+   inline SCTPNotificationEntry* getNotification();
 
    /**
      * Drop notification on head of queue.
@@ -165,7 +206,7 @@ class SCTPNotificationQueue
      * @param notificationFlags Flags (SCTP_RECVxxxx).
      * @return true if queue has data; false otherwise.
      */
-   bool hasData(const unsigned int notificationFlags);
+   inline bool hasData(const unsigned int notificationFlags);
 
 
    // ====== Waiting functions ==============================================
@@ -177,6 +218,11 @@ class SCTPNotificationQueue
      */
    inline bool waitForChunk(const card64 timeout);
 
+   /**
+     * Wait for new notification without timeout.
+     */
+   inline void waitForChunk();
+
    /**
      * Signalize, that new notification has arrived.
      */
@@ -194,22 +240,36 @@ class SCTPNotificationQueue
      *
      * @return Number of chunks.
      */
-   inline cardinal count() const;
+   inline cardinal count();
 
    /**
      * Get pointer to update condition.
      *
      * @return Update condition.
      */
-   inline Condition* getUpdateCondition();
+   inline LeanCondition* getUpdateCondition();
+
+   /**
+     * Get pool for entries and notifications of all queues.
+     *
+     * @return Pool.
+     */
+   static SCTPNotificationPool* getPool();
 
 
    // ====== Private data ===================================================
    private:
-   cardinal          Count;
-   SCTPNotification* First;
-   SCTPNotification* Last;
-   Condition         UpdateCondition;
+   void appendEntry(SCTPNotificationEntry* entry);
+   void countEntry(const SCTPNotificationEntry* entry, const bool added);
+   inline static unsigned int getEventFlag(const SCTPNotificationEntry* entry);
+
+   cardinal               Count;
+   cardinal               DataArrivals;
+   cardinal               EventCount[8];
+   unsigned int           PendingEvents;
+   SCTPNotificationEntry* First;
+   SCTPNotificationEntry* Last;
+   LeanCondition          UpdateCondition;
 };
 
 
@@ -80,6 +80,8 @@ SCTPSocket::SCTPSocket(const int family, const cardinal flags)
 {
    CorrelationID       = 0;
    AutoCloseTimeout    = 30000000;
+   EagerReceiveSize    = 0;
+   DescriptorReferences = 0;
    InstanceName        = 0;
    ConnectionRequests  = NULL;
    Flags               = flags;
@@ -89,14 +91,7 @@ SCTPSocket::SCTPSocket(const int family, const cardinal flags)
    WriteReady          = false;
    HasException        = false;
    Family              = family;
-
-   AutoCloseRecursion  = false;
-
-   EstablishCondition.setName("SCTPSocket::EstablishCondition");
-   ReadUpdateCondition.setName("SCTPSocket::ReadUpdateCondition");
-   WriteUpdateCondition.setName("SCTPSocket::WriteUpdateCondition");
-   ExceptUpdateCondition.setName("SCTPSocket::ExceptUpdateCondition");
-   GlobalQueue.getUpdateCondition()->setName("SCTPSocket::GlobalQueueCondition");
+   EventFD             = NULL;
 
    EstablishCondition.addParent(&ReadUpdateCondition);
    GlobalQueue.getUpdateCondition()->addParent(&ReadUpdateCondition);
@@ -107,6 +102,59 @@ SCTPSocket::SCTPSocket(const int family, const cardinal flags)
 SCTPSocket::~SCTPSocket()
 {
    unbind();
+
+   SCTPSocketMaster::MasterInstance.lock();
+   if(EventFD != NULL) {
+      ReadUpdateCondition.removeParent(EventFD);
+      WriteUpdateCondition.removeParent(EventFD);
+      ExceptUpdateCondition.removeParent(EventFD);
+      delete EventFD;
+      EventFD = NULL;
+   }
+   SCTPSocketMaster::MasterInstance.unlock();
+}
+
+
+// ###### Get event descriptor ##############################################
+int SCTPSocket::getEventFD()
+{
+   SCTPSocketMaster::MasterInstance.lock();
+   if(EventFD == NULL) {
+      EventFD = new EventFDCondition("SCTPSocket::EventFD");
+      if(EventFD->getFD() < 0) {
+         delete EventFD;
+         EventFD = NULL;
+         SCTPSocketMaster::MasterInstance.unlock();
+         return(-1);
+      }
+      // Adding the parent signals it if a condition has already fired.
+      ReadUpdateCondition.addParent(EventFD);
+      WriteUpdateCondition.addParent(EventFD);
+      ExceptUpdateCondition.addParent(EventFD);
+   }
+   const int fd = EventFD->getFD();
+   SCTPSocketMaster::MasterInstance.unlock();
+   return(fd);
+}
+
+
+// ###### Add descriptor reference ##########################################
+void SCTPSocket::addDescriptorReference()
+{
+   SCTPSocketMaster::MasterInstance.lock();
+   DescriptorReferences++;
+   SCTPSocketMaster::MasterInstance.unlock();
+}
+
+
+// ###### Remove descriptor reference #######################################
+bool SCTPSocket::removeDescriptorReference()
+{
+   SCTPSocketMaster::MasterInstance.lock();
+   DescriptorReferences--;
+   const bool last = (DescriptorReferences == 0);
+   SCTPSocketMaster::MasterInstance.unlock();
+   return(last);
 }
 
 
@@ -116,15 +164,17 @@ SCTPAssociation* SCTPSocket::getAssociationForAssociationID(const unsigned int a
 {
    SCTPAssociation* association = NULL;
 
-   SCTPSocketMaster::MasterInstance.lock();
-   std::multimap<unsigned int, SCTPAssociation*>::iterator iterator =
-      AssociationList.find(assocID);
-   if(iterator != AssociationList.end()) {
-      if(!((iterator->second->IsShuttingDown) && (activeOnly))) {
-         association = iterator->second;
+   // The association table lock is sufficient here, since associations
+   // are removed from the table before being deleted.
+   SCTPSocketMaster::AssociationTable.synchronized();
+   const SCTPAssociationTable::Entry* entry =
+      SCTPSocketMaster::AssociationTable.find(assocID);
+   if((entry != NULL) && (entry->Socket == this)) {
+      if(!((entry->Association->IsShuttingDown) && (activeOnly))) {
+         association = entry->Association;
       }
    }
-   SCTPSocketMaster::MasterInstance.unlock();
+   SCTPSocketMaster::AssociationTable.unsynchronized();
 
    return(association);
 }
@@ -318,7 +368,7 @@ int SCTPSocket::bind(const unsigned short    localPort,
          /* If the socket has been closed recently, it may not be deleted yet
             (by garbage collector thread). Therefore, we run the garbage collector
             now and try again ... */
-         SCTPSocketMaster::socketGarbageCollection();
+         SCTPSocketMaster::socketGarbageCollection(true);
          InstanceName = sctp_registerInstance(LocalPort, NoOfInStreams, NoOfOutStreams,
                                               NoOfLocalAddresses, LocalAddressList,
                                               SCTPSocketMaster::Callbacks);
@@ -357,6 +407,7 @@ void SCTPSocket::unbind(bool sendAbort)
       while(iterator != ConnectionlessAssociationList.end()) {
          SCTPAssociation* association = iterator->second;
          ConnectionlessAssociationList.erase(iterator);
+         SCTPSocketMaster::unscheduleAutoClose(association);
          if(sendAbort) {
             association->abort();
          }
@@ -453,9 +504,7 @@ SCTPAssociation* SCTPSocket::accept(SocketAddress*** addressArray,
       if(!wait) {
          return(NULL);
       }
-      while(EstablishCondition.timedWait(100000) == false) {
-         checkAutoConnect();
-      }
+      EstablishCondition.wait();
 
       SCTPSocketMaster::MasterInstance.lock();
    }
@@ -646,6 +695,7 @@ SCTPAssociation* SCTPSocket::associate(const unsigned short  noOfOutStreams,
             for(unsigned int i = 0;i < destinationAddresses;i++) {
                association->PreEstablishmentAddressList[i] =
                   destinationAddressList[i]->duplicate();
+               association->indexAddress(*destinationAddressList[i]);
             }
          }
 
@@ -720,9 +770,36 @@ int SCTPSocket::getErrorCode(const unsigned int assocID)
 }
 
 
+// ###### Store remote address of received message ##########################
+static void storeRemoteAddress(const sockaddr* remoteAddress,
+                               const socklen_t remoteAddressLength,
+                               SocketAddress** address,
+                               sockaddr*       systemAddress,
+                               socklen_t*      systemAddressLength,
+                               const socklen_t systemAddressCapacity)
+{
+   if(remoteAddress == NULL) {
+      return;
+   }
+   if(address) {
+      *address = SocketAddress::createSocketAddress(
+                    0, (sockaddr*)remoteAddress, remoteAddressLength);
+      if(*address == NULL) {
+         std::cerr << "INTERNAL ERROR: SCTPSocket::internalReceiver() - Unable to create destination address object!" << std::endl;
+      }
+   }
+   if((systemAddress != NULL) && (systemAddressLength != NULL)) {
+      memcpy(systemAddress, remoteAddress,
+             std::min(systemAddressCapacity, remoteAddressLength));
+      *systemAddressLength = remoteAddressLength;
+   }
+}
+
+
 // ###### Internal receive implementation ###################################
 int SCTPSocket::internalReceive(SCTPNotificationQueue& queue,
-                                char*                  buffer,
+                                const struct iovec*    iov,
+                                const size_t           iovlen,
                                 size_t&                bufferSize,
                                 int&                   flags,
                                 unsigned int&          assocID,
@@ -731,27 +808,64 @@ int SCTPSocket::internalReceive(SCTPNotificationQueue& queue,
                                 uint16_t&              ssn,
                                 uint32_t&              tsn,
                                 SocketAddress**        address,
+                                sockaddr*              systemAddress,
+                                socklen_t*             systemAddressLength,
                                 const unsigned int     notificationFlags)
 {
    // ====== Check parameters ===============================================
-   if(bufferSize == 0) {
+   size_t capacity = 0;
+   for(size_t i = 0;i < iovlen;i++) {
+      capacity += iov[i].iov_len;
+   }
+   bufferSize = 0;
+   socklen_t systemAddressCapacity = 0;
+   if(systemAddressLength != NULL) {
+      systemAddressCapacity = *systemAddressLength;
+      *systemAddressLength  = 0;
+   }
+   if(capacity == 0) {
 #ifndef DISABLE_WARNINGS
       std::cerr << "WARNING: SCTPSocket::internalReceive() - Data buffer size is zero!" << std::endl;
 #endif
       return(-EINVAL);
    }
+   flags &= ~MSG_EOR;
 
    // ====== Get next data or notification from queue =====================
 #ifdef PRINT_RECVWAIT
+   const card64 waitStart = getMicroTime();
    std::cout << "Waiting...";
    std::cout.flush();
 #endif
-   SCTPSocketMaster::MasterInstance.lock();
-   SCTPNotification notification;
-   bool received = queue.getNotification(notification);
-   while(received == false) {
+   // Lock order: SCTPSocketMaster lock first, then queue lock. Waiting,
+   // notifications and data in the receive ring (eager receive mode) only
+   // need the queue lock; the SCTPSocketMaster lock is only obtained when
+   // data has to be fetched from sctplib or the association's error state
+   // has to be checked.
+   bool                   masterLocked = false;
+   SCTPNotificationEntry* entry;
+   for(;;) {
+      queue.synchronized();
+      entry = queue.getNotification();
+      if(entry != NULL) {
+         if((entry->Notification != NULL) || (entry->Buffered) || (masterLocked)) {
+            break;
+         }
+         queue.unsynchronized();
+         SCTPSocketMaster::MasterInstance.lock();
+         masterLocked = true;
+         continue;
+      }
+      queue.unsynchronized();
+
+      // getErrorCode() accesses the association and its HasException flag,
+      // which are protected by the SCTPSocketMaster lock.
+      if(!masterLocked) {
+         SCTPSocketMaster::MasterInstance.lock();
+      }
       int errorCode = getErrorCode(assocID);
       SCTPSocketMaster::MasterInstance.unlock();
+      masterLocked = false;
 
       // ====== No chunk available -> wait for chunk ======================
       if(errorCode != 0) {
@@ -768,36 +882,90 @@ int SCTPSocket::internalReceive(SCTPNotificationQueue& queue,
       if(flags & MSG_DONTWAIT) {
          return(-EAGAIN);
       }
-      while(queue.waitForChunk(100000) == false) {
-         checkAutoConnect();
-      }
-      SCTPSocketMaster::MasterInstance.lock();
-      received = queue.getNotification(notification);
+
+      // ====== Wait for queue update ======================================
+      // New incoming associations of auto-connect sockets are signalled
+      // via the global queue, too.
+      queue.waitForChunk();
+      checkAutoConnect();
    }
 #ifdef PRINT_RECVWAIT
-   std::cout << "Wakeup!" << std::endl;
+   std::cout << "Wakeup after " << (getMicroTime() - waitStart) << " us!" << std::endl;
 #endif
 
 
    // ====== Read data ======================================================
    // If MSG_NOTIFICATION is set, notifications are received!
+   // The queue entry is updated in place; it is kept in the queue if
+   // there is remaining data or in peek mode.
    const bool receiveNotifications = (flags & MSG_NOTIFICATION);
    bool updatedNotification = false;
+   bool skippedNotification = false;
    int result               = 0;
-   if(notification.Content.sn_header.sn_type == SCTP_DATA_ARRIVE) {
+   if((entry->Notification == NULL) && (entry->Buffered)) {
+      // ====== Eager receive mode: data is in association's receive ring ===
+      flags &= ~MSG_NOTIFICATION;
+      sctp_data_arrive* sda = &entry->DataArrive;
+      assocID  = sda->sda_assoc_id;
+      streamID = sda->sda_stream;
+      protoID  = sda->sda_ppid;
+      if(sda->sda_flags & SCTP_ARRIVE_UNORDERED) {
+         flags |= MSG_UNORDERED;
+      }
+      // The queue lock is held for the whole ring access. The destructor of
+      // SCTPAssociation obtains it after making the association unreachable,
+      // so the association found here remains valid until it is released.
+      SCTPAssociation*        association = getAssociationForAssociationID(assocID, false);
+      SCTPMessageRing::Record record;
+      if((association != NULL) && (association->ReceiveRing != NULL) &&
+         (association->ReceiveRing->read(sda->sda_bytes_arrived, iov, iovlen, bufferSize, record))) {
+         ssn    = record.SSN;
+         tsn    = record.TSN;
+         result = (int)bufferSize;
+
+#ifdef PRINT_DATA
+         std::cout << "Received " << bufferSize << " bytes user data from receive ring of association " << assocID << ", stream " << streamID << std::endl;
+#endif
+         if(record.RemoteAddressLength > 0) {
+            storeRemoteAddress((const sockaddr*)&record.RemoteAddress, record.RemoteAddressLength,
+                               address, systemAddress, systemAddressLength,
+                               systemAddressCapacity);
+         }
+
+         // ====== Peek mode: Keep message in receive ring ==================
+         if(flags & MSG_PEEK) {
+            updatedNotification = true;
+         }
+         else {
+            sda->sda_bytes_arrived -= bufferSize;
+            if(sda->sda_bytes_arrived > 0) {
+               updatedNotification = true;
+            }
+            else {
+               association->ReceiveRing->drop();
+               flags |= MSG_EOR;
+            }
+         }
+      }
+      else {
+         bufferSize = 0;
+         result     = -ECONNABORTED;
+      }
+   }
+   else if(entry->Notification == NULL) {
       // ====== Some test stuff for the partial delivery API ================
 #ifdef TEST_PARTIAL_DELIVERY
 #ifdef PRINT_PARTIAL_DELIVERY
-      std::cout << "Partial Delivery Test: " << bufferSize << " -> ";
+      std::cout << "Partial Delivery Test: " << capacity << " -> ";
 #endif
-      bufferSize = MIN(bufferSize, PARTIAL_DELIVERY_MAXSIZE);
+      capacity = MIN(capacity, PARTIAL_DELIVERY_MAXSIZE);
 #ifdef PRINT_PARTIAL_DELIVERY
-      std::cout << bufferSize << std::endl;
+      std::cout << capacity << std::endl;
 #endif
 #endif
 
       flags &= ~MSG_NOTIFICATION;
-      sctp_data_arrive* sda = &notification.Content.sn_data_arrive;
+      sctp_data_arrive* sda = &entry->DataArrive;
       if(sda->sda_bytes_arrived > 0) {
          assocID  = sda->sda_assoc_id;
          streamID = sda->sda_stream;
@@ -805,75 +973,93 @@ int SCTPSocket::internalReceive(SCTPNotificationQueue& queue,
          if(sda->sda_flags & SCTP_ARRIVE_UNORDERED) {
             flags |= MSG_UNORDERED;
          }
-         unsigned int receivedBytes = std::min((size_t) sda->sda_bytes_arrived, (size_t) bufferSize);
+
+         // ====== Scatter message into the buffers ==========================
+         // sctplib delivers a message in parts; the remaining part is
+         // delivered by the next sctp_receive() call. In peek mode, each
+         // call returns the beginning of the message, so only the first
+         // buffer is filled.
+         const size_t toReceive = std::min((size_t)sda->sda_bytes_arrived, capacity);
+         int          ok        = 0;
+#if (SCTPLIB_VERSION == SCTPLIB_1_0_0)
+         unsigned int pathIndex = 0;
+#endif
+         for(size_t i = 0;(i < iovlen) && (bufferSize < toReceive);i++) {
+            unsigned int receivedBytes = (unsigned int)std::min(iov[i].iov_len, toReceive - bufferSize);
+            if(receivedBytes == 0) {
+               continue;
+            }
 #if (SCTPLIB_VERSION == SCTPLIB_1_0_0)
-         unsigned int pathIndex;
-         const int ok = sctp_receivefrom(assocID, streamID,
-                                         (unsigned char*)buffer,
-                                         (unsigned int*)&receivedBytes,
-                                         &ssn,
-                                         &tsn,
-                                         &pathIndex,
-                                         (flags & MSG_PEEK) ? SCTP_MSG_PEEK : SCTP_MSG_DEFAULT);
+            ok = sctp_receivefrom(assocID, streamID,
+                                  (unsigned char*)iov[i].iov_base,
+                                  (unsigned int*)&receivedBytes,
+                                  &ssn,
+                                  &tsn,
+                                  &pathIndex,
+                                  (flags & MSG_PEEK) ? SCTP_MSG_PEEK : SCTP_MSG_DEFAULT);
 #elif (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE19) || (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE20) || (SCTPLIB_VERSION == SCTPLIB_1_3_0)
-         const int ok = sctp_receive(assocID, streamID,
-                                     (unsigned char*)buffer,
-                                     (unsigned int*)&receivedBytes,
-                                     &ssn,
-                                     &tsn,
-                                     (flags & MSG_PEEK) ? SCTP_MSG_PEEK : SCTP_MSG_DEFAULT);
-         const int pathIndex = sctp_getPrimary(assocID);
+            ok = sctp_receive(assocID, streamID,
+                              (unsigned char*)iov[i].iov_base,
+                              (unsigned int*)&receivedBytes,
+                              &ssn,
+                              &tsn,
+                              (flags & MSG_PEEK) ? SCTP_MSG_PEEK : SCTP_MSG_DEFAULT);
 #else
 #error Wrong sctplib version!
 #endif
-         if(ok == 0) {
-            bufferSize = receivedBytes;
-
+            if(ok != 0) {
+               break;
+            }
+            bufferSize += receivedBytes;
+            if(flags & MSG_PEEK) {
+               break;
+            }
+         }
+#if (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE19) || (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE20) || (SCTPLIB_VERSION == SCTPLIB_1_3_0)
+         const int pathIndex = sctp_getPrimary(assocID);
+#endif
+         // Data already taken from sctplib has to be delivered, even if a
+         // subsequent call has failed.
+         if((ok == 0) || (bufferSize > 0)) {
 #ifdef PRINT_DATA
             std::cout << "Received " << bufferSize << " bytes user data from association " << assocID << ", stream " << streamID << ":" << std::endl;
-            for(size_t i = 0;i < bufferSize;i++) {
-               char str[32];
-               snprintf((char*)&str,sizeof(str),"%02x ",((unsigned char*)buffer)[i]);
-               std::cout << str;
+            size_t printed = 0;
+            for(size_t i = 0;(i < iovlen) && (printed < bufferSize);i++) {
+               for(size_t j = 0;(j < iov[i].iov_len) && (printed < bufferSize);j++, printed++) {
+                  char str[32];
+                  snprintf((char*)&str,sizeof(str),"%02x ",((unsigned char*)iov[i].iov_base)[j]);
+                  std::cout << str;
+               }
             }
             std::cout << std::endl;
 #endif
             result = (int)bufferSize;
 
-            SCTP_PathStatus pathStatus;
-            SCTP_AssociationStatus assocStatus;
-            if(address) {
-               if(sctp_getPathStatus(assocID, pathIndex, &pathStatus) != 0) {
-                  std::cerr << "INTERNAL ERROR: SCTPSocket::internalReceiver() - sctp_getPathStatus() failed!" << std::endl;
-               }
-               else {
-                  if(sctp_getAssocStatus(assocID, &assocStatus) != 0) {
-                     std::cerr << "INTERNAL ERROR: SCTPSocket::internalReceiver() - sctp_getAssocStatus() failed!" << std::endl;
-                  }
-                  else {
-                     *address = SocketAddress::createSocketAddress(
-                                   0, (char*)&pathStatus.destinationAddress, assocStatus.destPort);
-                     if(*address == NULL) {
-                        std::cerr << "INTERNAL ERROR: SCTPSocket::internalReceiver() - Unable to create destination address object!" << std::endl;
-                     }
+            // ====== Get remote address from association's path cache ====
+            if((address) || (systemAddress)) {
+               SCTPAssociation* association = getAssociationForAssociationID(assocID, false);
+               if(association != NULL) {
+                  socklen_t       remoteAddressLength;
+                  const sockaddr* remoteAddress =
+                     association->getPathSystemAddress((unsigned int)pathIndex, remoteAddressLength);
+                  storeRemoteAddress(remoteAddress, remoteAddressLength,
+                                     address, systemAddress, systemAddressLength,
+                                     systemAddressCapacity);
 #ifdef PRINT_DATA
-                     else {
-                        std::cout << "Received via address " << *(*address) << " (path index " << pathIndex << ")." << std::endl;
-                     }
-#endif
+                  if((address) && (*address != NULL)) {
+                     std::cout << "Received via address " << *(*address) << " (path index " << pathIndex << ")." << std::endl;
                   }
+#endif
                }
             }
 
-            // ====== Peek mode: Restore chunk arrival information ==========
+            // ====== Peek mode: Keep chunk arrival information ============
             if(flags & MSG_PEEK) {
-               queue.updateNotification(notification);
                updatedNotification = true;
             }
             else {
-               sda->sda_bytes_arrived -= receivedBytes;
+               sda->sda_bytes_arrived -= bufferSize;
                if(sda->sda_bytes_arrived > 0) {
-                  queue.updateNotification(notification);
                   updatedNotification = true;
                }
                else {
@@ -893,6 +1079,7 @@ int SCTPSocket::internalReceive(SCTPNotificationQueue& queue,
 
    // ====== Handle notification ============================================
    else {
+      SCTPNotification& notification = *entry->Notification;
       switch(notification.Content.sn_header.sn_type) {
          case SCTP_ASSOC_CHANGE:
             assocID = notification.Content.sn_assoc_change.sac_assoc_id;
@@ -924,23 +1111,26 @@ int SCTPSocket::internalReceive(SCTPNotificationQueue& queue,
           ((notification.Content.sn_header.sn_type == SCTP_REMOTE_ERROR)     && (notificationFlags & SCTP_RECVPEERERR))   ||
           ((notification.Content.sn_header.sn_type == SCTP_SEND_FAILED)      && (notificationFlags & SCTP_RECVSENDFAILEVNT)) ||
           ((notification.Content.sn_header.sn_type == SCTP_SHUTDOWN_EVENT)   && (notificationFlags & SCTP_RECVSHUTDOWNEVNT)))) {
-         const cardinal toCopy = std::min((cardinal)notification.Content.sn_header.sn_length - notification.ContentPosition,(cardinal)bufferSize);
-         const char* from = (char*)&notification.Content;
-         memcpy(buffer,&from[notification.ContentPosition],toCopy);
-         bufferSize = toCopy;
-         notification.ContentPosition += toCopy;
+         const char*    from          = (char*)&notification.Content;
+#ifdef PRINT_DATA
+         const cardinal startPosition = notification.ContentPosition;
+#endif
+         for(size_t i = 0;i < iovlen;i++) {
+            const cardinal toCopy = std::min((cardinal)notification.Content.sn_header.sn_length - notification.ContentPosition,(cardinal)iov[i].iov_len);
+            memcpy(iov[i].iov_base,&from[notification.ContentPosition],toCopy);
+            bufferSize += toCopy;
+            notification.ContentPosition += toCopy;
+         }
          if(notification.ContentPosition < notification.Content.sn_header.sn_length) {
             if(flags & MSG_PEEK) {
                notification.ContentPosition = 0;
             }
-            queue.updateNotification(notification);
             updatedNotification = true;
             flags |= MSG_NOTIFICATION;
          }
          else {
             if(flags & MSG_PEEK) {
                notification.ContentPosition = 0;
-               queue.updateNotification(notification);
                updatedNotification = true;
             }
             flags |= (MSG_EOR|MSG_NOTIFICATION);
@@ -950,7 +1140,7 @@ int SCTPSocket::internalReceive(SCTPNotificationQueue& queue,
          std::cout << "Received " << bufferSize << " bytes notification data from association " << assocID << ", stream " << streamID << ":" << std::endl;
          for(size_t i = 0;i < bufferSize;i++) {
             char str[32];
-            snprintf((char*)&str,sizeof(str),"%02x ",((unsigned char*)buffer)[i]);
+            snprintf((char*)&str,sizeof(str),"%02x ",((unsigned char*)&from[startPosition])[i]);
             std::cout << str;
          }
          std::cout << std::endl;
@@ -970,21 +1160,37 @@ int SCTPSocket::internalReceive(SCTPNotificationQueue& queue,
             }
             std::cout << std::endl;
 #endif
-         result = getErrorCode(assocID);
-         if(result == 0) {
-            result = -EAGAIN;
-            flags &= ~MSG_NOTIFICATION;
-         }
+         // The error code is obtained after dropping the notification,
+         // since getErrorCode() needs the SCTPSocketMaster lock.
+         skippedNotification = true;
       }
    }
 
 
    // ====== Drop notification, if not updated ==============================
    if(!updatedNotification) {
+      const bool unbufferedData = (entry->Notification == NULL) && (!entry->Buffered);
       queue.dropNotification();
+      queue.unsynchronized();
+
+      // ====== Update usage and readiness state ===========================
+      if(!masterLocked) {
+         SCTPSocketMaster::MasterInstance.lock();
+         masterLocked = true;
+      }
+      if(skippedNotification) {
+         result = getErrorCode(assocID);
+         if(result == 0) {
+            result = -EAGAIN;
+            flags &= ~MSG_NOTIFICATION;
+         }
+      }
       SCTPAssociation* association = getAssociationForAssociationID(assocID, false);
       if(association != NULL) {
          association->LastUsage = getMicroTime();
+         if((unbufferedData) && (association->UnbufferedArrivals > 0)) {
+            association->UnbufferedArrivals--;
+         }
          if(association->UseCount > 0) {
 #ifdef PRINT_ASSOC_USECOUNT
             std::cout << "Receive: UseCount decrement for A" << association->getID() << ": "
@@ -1012,6 +1218,9 @@ int SCTPSocket::internalReceive(SCTPNotificationQueue& queue,
       std::cout << "Instance " << InstanceName << ": ReadReady=" << ReadReady << std::endl;
 #endif
    }
+   else {
+      queue.unsynchronized();
+   }
 
 #ifdef TEST_PARTIAL_DELIVERY
 #ifdef PRINT_PARTIAL_DELIVERY
@@ -1019,7 +1228,9 @@ int SCTPSocket::internalReceive(SCTPNotificationQueue& queue,
 #endif
 #endif
 
-   SCTPSocketMaster::MasterInstance.unlock();
+   if(masterLocked) {
+      SCTPSocketMaster::MasterInstance.unlock();
+   }
    return(result);
 }
 
@@ -1032,7 +1243,7 @@ int SCTPSocket::internalSend(const char*          buffer,
                              const unsigned short streamID,
                              const unsigned int   protoID,
                              const unsigned int   timeToLive,
-                             Condition*           waitCondition,
+                             LeanCondition*       waitCondition,
                              const SocketAddress* pathDestinationAddress)
 {
    // ====== Check error code ===============================================
@@ -1046,6 +1257,12 @@ int SCTPSocket::internalSend(const char*          buffer,
    do {
       SCTPSocketMaster::MasterInstance.lock();
 
+      // A queue status change notification after this point will wake up
+      // the waiting below. Older ones are obsolete.
+      if(waitCondition != NULL) {
+         waitCondition->fired();
+      }
+
       int pathIndex = sctp_getPrimary(assocID);
       if((pathDestinationAddress) && (flags & MSG_ADDR_OVER)) {
          SCTP_PathStatus pathStatus;
@@ -1097,7 +1314,7 @@ int SCTPSocket::internalSend(const char*          buffer,
       if((result == SCTP_QUEUE_EXCEEDED) && (!(flags & MSG_DONTWAIT))) {
          if(waitCondition != NULL) {
             SCTPSocketMaster::MasterInstance.unlock();
-            waitCondition->timedWait(100000);
+            waitCondition->wait();
             SCTPSocketMaster::MasterInstance.lock();
          }
       }
@@ -1150,12 +1367,9 @@ int SCTPSocket::receive(char*           buffer,
 bool SCTPSocket::hasData()
 {
    bool result = false;
-
-   SCTPSocketMaster::MasterInstance.lock();
    if(Flags & SSF_GlobalQueue) {
       result = GlobalQueue.hasData(NotificationFlags);
    }
-   SCTPSocketMaster::MasterInstance.unlock();
    return(result);
 }
 
@@ -1170,6 +1384,42 @@ int SCTPSocket::receiveFrom(char*           buffer,
                             uint16_t&       ssn,
                             uint32_t&       tsn,
                             SocketAddress** address)
+{
+   // ====== Receive ========================================================
+   if(!(Flags & SSF_GlobalQueue)) {
+      // std::cerr << "WARNING: SCTPSocket::receiveFrom() - No global queue!" << std::endl;
+      return(-EBADF);
+   }
+   assocID = 0;
+   const struct iovec iov    = { buffer, bufferSize };
+   const int          result = internalReceive(
+                                  GlobalQueue,
+                                  &iov, 1, bufferSize,
+                                  flags,
+                                  assocID, streamID, protoID,
+                                  ssn, tsn,
+                                  address, NULL, NULL,
+                                  NotificationFlags);
+
+   // ====== Check, if association has to be closed =========================
+   checkAutoConnect();
+
+   return(result);
+}
+
+
+// ###### Receive into scatter list ##########################################
+int SCTPSocket::receiveFrom(const struct iovec* iov,
+                            const size_t        iovlen,
+                            size_t&             bufferSize,
+                            int&                flags,
+                            unsigned int&       assocID,
+                            unsigned short&     streamID,
+                            unsigned int&       protoID,
+                            uint16_t&           ssn,
+                            uint32_t&           tsn,
+                            sockaddr*           systemAddress,
+                            socklen_t*          systemAddressLength)
 {
    // ====== Receive ========================================================
    if(!(Flags & SSF_GlobalQueue)) {
@@ -1179,11 +1429,11 @@ int SCTPSocket::receiveFrom(char*           buffer,
    assocID = 0;
    const int result = internalReceive(
                          GlobalQueue,
-                         buffer, bufferSize,
+                         iov, iovlen, bufferSize,
                          flags,
                          assocID, streamID, protoID,
                          ssn, tsn,
-                         address,
+                         NULL, systemAddress, systemAddressLength,
                          NotificationFlags);
 
    // ====== Check, if association has to be closed =========================
@@ -1193,64 +1443,58 @@ int SCTPSocket::receiveFrom(char*           buffer,
 }
 
 
+// ###### Check, if sending would establish a new association ###############
+bool SCTPSocket::wouldAutoConnect(const SocketAddress** destinationAddressList)
+{
+   if((!(Flags & SSF_AutoConnect)) || (destinationAddressList == NULL)) {
+      return(false);
+   }
+   SCTPSocketMaster::MasterInstance.lock();
+   const bool result = (findAssociationForDestinationAddress(destinationAddressList) == NULL);
+   SCTPSocketMaster::MasterInstance.unlock();
+   return(result);
+}
+
+
 // ###### Find association for given destination address ####################
+// The SCTPSocketMaster lock must be held.
 SCTPAssociation* SCTPSocket::findAssociationForDestinationAddress(
-                    std::multimap<unsigned int, SCTPAssociation*>& list,
                     const SocketAddress** destinationAddressList)
 {
-   SCTP_PathStatus pathStatus;
-   short           pathIndex;
-
-   std::multimap<unsigned int, SCTPAssociation*>::iterator iterator = list.begin();
-   while(iterator != list.end()) {
-      SCTP_Association_Status assocStatus;
-      if(iterator->second->PreEstablishmentAddressList == NULL) {
-         if(sctp_getAssocStatus(iterator->second->AssociationID, &assocStatus) == 0) {
-            size_t i = 0;
-            while(destinationAddressList[i] != NULL) {
-#ifdef PRINT_ASSOCSEARCH
-               std::cout << "Check "
-                         << destinationAddressList[i]->getAddressString(InternetAddress::PF_Address|InternetAddress::PF_Legacy)
-                         << " in AssocID=" << iterator->second->AssociationID << "?" << std::endl;
-#endif
-               if( (!iterator->second->IsShuttingDown) &&
-                  (destinationAddressList[i]->getPort() == assocStatus.destPort) &&
-                  ((pathIndex = getPathIndexForAddress(iterator->second->AssociationID, destinationAddressList[i], pathStatus)) >= 0) ) {
+   SCTPAssociation* found = NULL;
+   size_t           i     = 0;
+   while(destinationAddressList[i] != NULL) {
+      SCTPAddressIndex::Key key;
+      if(SCTPAddressIndex::getKey(*destinationAddressList[i], key)) {
+         cardinal         position = 0;
+         SCTPAssociation* association;
+         while((association = AddressIndex.find(key, position)) != NULL) {
 #ifdef PRINT_ASSOCSEARCH
-                  std::cout << "Found: index=" << pathIndex << std::endl;
+            std::cout << "Check "
+                      << destinationAddressList[i]->getAddressString(InternetAddress::PF_Address|InternetAddress::PF_Legacy)
+                      << " in AssocID=" << association->AssociationID << "?" << std::endl;
 #endif
-                  return(iterator->second);
-               }
-               i++;
+            if( (association->IsShuttingDown) || (association->isClosed()) ) {
+               continue;
             }
-         }
-      }
-      else {
-         size_t i = 0;
-         size_t j = 0;
-         while(destinationAddressList[i] != NULL) {
-            while(iterator->second->PreEstablishmentAddressList[j] != NULL) {
-#ifdef PRINT_ASSOCSEARCH
-               std::cout << "PreEstablishmentAddressList Check "
-                         << destinationAddressList[i]->getAddressString(InternetAddress::PF_Address|InternetAddress::PF_Legacy)
-                         << " == "
-                         << iterator->second->PreEstablishmentAddressList[j]->getAddressString(InternetAddress::PF_Address|InternetAddress::PF_Legacy) << std::endl;
-#endif
-               if(destinationAddressList[i]->getAddressString(InternetAddress::PF_Address|InternetAddress::PF_Legacy) ==
-                  iterator->second->PreEstablishmentAddressList[j]->getAddressString(InternetAddress::PF_Address|InternetAddress::PF_Legacy)) {
+            // Connectionless associations take precedence, as for the
+            // original lookup in ConnectionlessAssociationList first.
+            if( (!(Flags & SSF_AutoConnect)) ||
+                (ConnectionlessAssociationList.find(association->AssociationID) !=
+                    ConnectionlessAssociationList.end()) ) {
 #ifdef PRINT_ASSOCSEARCH
-                  std::cout << "Found" << std::endl;
+               std::cout << "Found" << std::endl;
 #endif
-                  return(iterator->second);
-               }
-               j++;
+               return(association);
+            }
+            if(found == NULL) {
+               found = association;
             }
-            i++;
          }
       }
-      iterator++;
+      i++;
    }
-   return(NULL);
+   return(found);
 }
 
 
@@ -1280,20 +1524,10 @@ int SCTPSocket::sendTo(const char*           buffer,
       // ====== Check for already created association =======================
       SCTPAssociation* association = NULL;
       if(destinationAddressList != NULL) {
-         if(Flags & SSF_AutoConnect) {
-#ifdef PRINT_ASSOCSEARCH
-            std::cout << "Assoc lookup in ConnectionlessAssociationList..." << std::endl;
-#endif
-            association = findAssociationForDestinationAddress(ConnectionlessAssociationList,
-                                                               destinationAddressList);
-         }
-         if(association == NULL) {
 #ifdef PRINT_ASSOCSEARCH
-            std::cout << "Assoc lookup in AssociationList..." << std::endl;
+         std::cout << "Assoc lookup in AddressIndex..." << std::endl;
 #endif
-            association = findAssociationForDestinationAddress(AssociationList,
-                                                               destinationAddressList);
-         }
+         association = findAssociationForDestinationAddress(destinationAddressList);
       }
       else {
 #ifdef PRINT_ASSOCSEARCH
@@ -1379,6 +1613,7 @@ int SCTPSocket::sendTo(const char*           buffer,
             std::cout << association->UseCount << std::endl;
 #endif
             ConnectionlessAssociationList.insert(std::pair<unsigned int, SCTPAssociation*>(association->getID(),association));
+            SCTPSocketMaster::scheduleAutoClose(association, 0);
             SCTPSocketMaster::MasterInstance.unlock();
          }
 #ifdef PRINT_NEW_ASSOCIATIONS
@@ -1437,6 +1672,7 @@ int SCTPSocket::sendTo(const char*           buffer,
                if(iterator != ConnectionlessAssociationList.end()) {
                   ConnectionlessAssociationList.erase(iterator);
                }
+               SCTPSocketMaster::unscheduleAutoClose(association);
                SCTPSocketMaster::MasterInstance.unlock();
                delete association;
                association = NULL;
@@ -1536,6 +1772,7 @@ SCTPAssociation* SCTPSocket::peelOff(const SocketAddress& destinationAddress)
             association = iterator->second;
             association->PeeledOff = true;
             ConnectionlessAssociationList.erase(iterator);
+            SCTPSocketMaster::unscheduleAutoClose(association);
             break;
          }
       }
@@ -1560,6 +1797,7 @@ SCTPAssociation* SCTPSocket::peelOff(const unsigned int assocID)
       association = iterator->second;
       association->PeeledOff = true;
       ConnectionlessAssociationList.erase(iterator);
+      SCTPSocketMaster::unscheduleAutoClose(association);
    }
    SCTPSocketMaster::MasterInstance.unlock();
 
@@ -1977,105 +2215,120 @@ bool SCTPSocket::deleteAddress(const unsigned int   assocID,
 }
 
 
-// ###### Check for necessity to auto-close associations ####################
-void SCTPSocket::checkAutoClose()
+// ###### Set AutoClose parameter ###########################################
+void SCTPSocket::setAutoClose(const card64 timeout)
 {
-   if(AutoCloseRecursion) {
-      AutoCloseNewCheckRequired = true;
-      return;
+   SCTPSocketMaster::MasterInstance.lock();
+   AutoCloseTimeout = timeout;
+
+   // ====== Deadlines have changed -> check all associations again =========
+   std::multimap<unsigned int, SCTPAssociation*>::iterator iterator =
+      ConnectionlessAssociationList.begin();
+   while(iterator != ConnectionlessAssociationList.end()) {
+      SCTPSocketMaster::scheduleAutoClose(iterator->second, 0);
+      iterator++;
    }
-   AutoCloseRecursion = true;
+   SCTPSocketMaster::MasterInstance.unlock();
+}
 
-   do {
-      AutoCloseNewCheckRequired = false;
 
-      const card64 now = getMicroTime();
-      std::multimap<unsigned int, SCTPAssociation*>::iterator iterator =
-         ConnectionlessAssociationList.begin();
-      while(iterator != ConnectionlessAssociationList.end()) {
-         SCTPAssociation* association = iterator->second;
+// ###### Check for necessity to auto-close association #####################
+// This function is called by SCTPSocketMaster::autoCloseCollection() for an
+// association of ConnectionlessAssociationList, when its deadline is due.
+// Unless the association is deleted, it is rescheduled for its next deadline.
+void SCTPSocket::checkAutoClose(SCTPAssociation* association, const card64 now)
+{
 #ifdef PRINT_AUTOCLOSE_CHECK
-         std::cout << "AutoConnect: Check for AutoClose:" << std::endl
-                   << "   AssocID          = " << association->getID() << std::endl
-                   << "   UseCount         = " << association->UseCount << std::endl
-                   << "   LastUsage        = " << now - association->LastUsage << std::endl
-                   << "   AutoCloseTimeout = " << AutoCloseTimeout << std::endl;
-#endif
-
-         /* ====== Association has no active users ======================= */
-         if(association->UseCount == 0) {
-            /* ====== Association is closed -> remove it ================= */
-            if((association->ShutdownCompleteNotification) ||
-               (association->CommunicationLostNotification)) {
+   std::cout << "AutoConnect: Check for AutoClose:" << std::endl
+             << "   AssocID          = " << association->getID() << std::endl
+             << "   UseCount         = " << association->UseCount << std::endl
+             << "   LastUsage        = " << now - association->LastUsage << std::endl
+             << "   AutoCloseTimeout = " << AutoCloseTimeout << std::endl;
+#endif
+
+   /* ====== Association has no active users ============================== */
+   if(association->UseCount == 0) {
+      /* ====== Association is closed -> remove it ======================== */
+      if((association->ShutdownCompleteNotification) ||
+         (association->CommunicationLostNotification)) {
 #ifdef PRINT_AUTOCLOSE_TIMEOUT
-               const unsigned int assocID = association->getID();
-               std::cout << "AutoConnect: Removing association #" << assocID << ": ";
-               if(association->ShutdownCompleteNotification) {
-                  std::cout << "shutdown complete";
-               }
-               else if(association->CommunicationLostNotification) {
-                  std::cout << "communication lost";
-               }
-               std::cout << "..." << std::endl;
+         const unsigned int assocID = association->getID();
+         std::cout << "AutoConnect: Removing association #" << assocID << ": ";
+         if(association->ShutdownCompleteNotification) {
+            std::cout << "shutdown complete";
+         }
+         else if(association->CommunicationLostNotification) {
+            std::cout << "communication lost";
+         }
+         std::cout << "..." << std::endl;
 #endif
-
-               // Important! Removal will invalidate iterator!
-               std::multimap<unsigned int, SCTPAssociation*>::iterator delIterator = iterator;
-               iterator++;
-               ConnectionlessAssociationList.erase(delIterator);
-
-               delete association;
+         std::multimap<unsigned int, SCTPAssociation*>::iterator iterator =
+            ConnectionlessAssociationList.find(association->getID());
+         if(iterator != ConnectionlessAssociationList.end()) {
+            ConnectionlessAssociationList.erase(iterator);
+         }
+         delete association;
 #ifdef PRINT_AUTOCLOSE_TIMEOUT
-               std::cout << "AutoConnect: AutoClose of association #" << assocID << " completed!" << std::endl;
+         std::cout << "AutoConnect: AutoClose of association #" << assocID << " completed!" << std::endl;
 #endif
-            }
+         return;
+      }
 
-            /* ====== Association still active, time to send ABORT! ====== */
-            else if((AutoCloseTimeout > 0) &&
-                    (now - association->LastUsage > 4 * AutoCloseTimeout)) {
+      /* ====== Association still active, time to send ABORT! ============= */
+      else if((AutoCloseTimeout > 0) &&
+              (now - association->LastUsage > 4 * AutoCloseTimeout)) {
 #ifdef PRINT_AUTOCLOSE_TIMEOUT
-               const unsigned int assocID = association->getID();
-               std::cout << "AutoConnect: Abort of association #" << assocID << " due to timeout" << std::endl;
+         std::cout << "AutoConnect: Abort of association #" << association->getID() << " due to timeout" << std::endl;
 #endif
-               iterator++;   // Important! shutdown() may invalidate iterator!
-               association->abort();
-            }
+         association->abort();
+      }
 
-            /* ====== Association still active, but timeout has expired == */
-            else if((AutoCloseTimeout > 0) &&
-                    (now - association->LastUsage > AutoCloseTimeout) &&
-                    (!association->IsShuttingDown)) {
+      /* ====== Association still active, but timeout has expired ========= */
+      else if((AutoCloseTimeout > 0) &&
+              (now - association->LastUsage > AutoCloseTimeout) &&
+              (!association->IsShuttingDown)) {
 #ifdef PRINT_AUTOCLOSE_TIMEOUT
-               const unsigned int assocID = association->getID();
-               std::cout << "AutoConnect: Doing shutdown of association #" << assocID << " due to timeout" << std::endl;
+         std::cout << "AutoConnect: Doing shutdown of association #" << association->getID() << " due to timeout" << std::endl;
 #endif
-               iterator++;   // Important! shutdown() may invalidate iterator!
-               association->shutdown();
-            }
-
-            /* ====== Association is waiting for shutdown/abort ========== */
-            else {
-               iterator++;
-            }
-         }
-
-         /* ====== Association is still in use =========================== */
-         else {
-            // Skip this association
-            iterator++;
+         association->shutdown();
+      }
+   }
 
-            // The association is closed, but somebody is still using it.
-            // We will remove it later ...
-            if((association->ShutdownCompleteNotification) ||
-               (association->CommunicationLostNotification)) {
+   /* ====== Association is still in use =================================== */
 #ifdef PRINT_AUTOCLOSE_TIMEOUT
-               std::cout << "AutoConnect: Association #" << association->getID() << " is disconnected but still has users!" << std::endl;
-#endif
-            }
-         }
-      }
-   } while(AutoCloseNewCheckRequired == true);
-   AutoCloseRecursion = false;
+   else if((association->ShutdownCompleteNotification) ||
+           (association->CommunicationLostNotification)) {
+      // The association is closed, but somebody is still using it.
+      // We will remove it later ...
+      std::cout << "AutoConnect: Association #" << association->getID() << " is disconnected but still has users!" << std::endl;
+   }
+#endif
+
+   /* ====== Schedule next check ============================================ */
+   // The closing callbacks of abort() or shutdown() only schedule an
+   // immediate check when the association is queued. It is not queued
+   // while being checked here, so a closing caused by abort() or shutdown()
+   // above is handled here.
+   if(!association->AutoCloseQueued) {
+      const bool closed = (association->ShutdownCompleteNotification) ||
+                          (association->CommunicationLostNotification);
+      card64 deadline = ~((card64)0);
+      if(AutoCloseTimeout > 0) {
+         deadline = association->LastUsage +
+                       ((association->IsShuttingDown) ? 4 * AutoCloseTimeout : AutoCloseTimeout);
+      }
+      // Closed and unused: remove it immediately, i.e. within the current
+      // loop of SCTPSocketMaster::autoCloseCollection().
+      if((closed) && (association->UseCount == 0)) {
+         deadline = now;
+      }
+      // Closed, but still used, or timed out, but still used:
+      // check again later.
+      else if((deadline <= now) || (closed)) {
+         deadline = now + SCTPSocketMaster::GarbageCollectionInterval;
+      }
+      SCTPSocketMaster::scheduleAutoClose(association, deadline);
+   }
 }
 
 
@@ -2094,6 +2347,7 @@ void SCTPSocket::checkAutoConnect()
          std::cout << "AutoConnect: New incoming association #" << association->getID() << "..." << std::endl;
 #endif
          ConnectionlessAssociationList.insert(std::pair<unsigned int, SCTPAssociation*>(association->getID(),association));
+         SCTPSocketMaster::scheduleAutoClose(association, 0);
          association = accept(NULL,false);
       }
       Flags = oldFlags;
@@ -42,8 +42,10 @@
 
 #include "tdsystem.h"
 #include "condition.h"
+#include "eventfdcondition.h"
 #include "internetaddress.h"
 #include "sctpassociation.h"
+#include "sctpaddressindex.h"
 #include "sctpnotificationqueue.h"
 
 #include <sctp.h>
@@ -249,6 +251,35 @@ class SCTPSocket
                    uint32_t&       tsn,
                    SocketAddress** addressArray);
 
+   /**
+     * Receive data into a scatter list. All buffers are filled from one
+     * message in a single pass.
+     *
+     * @param iov Buffers to store data to.
+     * @param iovlen Number of buffers.
+     * @param bufferSize Variable to store actual size of data content to.
+     * @param flags Flags; this will be overwritten with actual reception flags.
+     * @param assocID Variable to store association ID to.
+     * @param streamID Variable to store stream ID to.
+     * @param protoID Variable to store protocol ID to.
+     * @param ssn Variable to store SSN to.
+     * @param tsn Variable to store TSN to.
+     * @param systemAddress Buffer to store the remote address to, as sockaddr of the socket's family. It is copied from the association's path cache. Set NULL to skip the address.
+     * @param systemAddressLength Input: size of systemAddress buffer; Output: length of remote address (0 if unknown).
+     * @return error code (0 for success).
+     */
+   int receiveFrom(const struct iovec* iov,
+                   const size_t        iovlen,
+                   size_t&             bufferSize,
+                   int&                flags,
+                   unsigned int&       assocID,
+                   unsigned short&     streamID,
+                   unsigned int&       protoID,
+                   uint16_t&           ssn,
+                   uint32_t&           tsn,
+                   sockaddr*           systemAddress,
+                   socklen_t*          systemAddressLength);
+
    /**
      * Send data.
      *
@@ -476,7 +507,26 @@ class SCTPSocket
      *
      * @param timeout Timeout in microseconds.
      */
-   inline void setAutoClose(const card64 timeout);
+   void setAutoClose(const card64 timeout);
+
+   /**
+     * Get eager receive ring buffer size.
+     *
+     * @return Ring buffer size in bytes (0 if eager receive mode is off).
+     */
+   inline cardinal getEagerReceive() const;
+
+   /**
+     * Set eager receive mode. In eager receive mode, arriving messages are
+     * copied from sctplib into a ring buffer of their association by the
+     * SCTPSocketMaster thread. Receive calls are completed from this ring
+     * buffer without calling sctplib. Messages not fitting into the ring
+     * buffer are received from sctplib as usual. The ring buffer size of
+     * an association is fixed when its first message arrives.
+     *
+     * @param size Ring buffer size in bytes (0 to turn eager receive mode off).
+     */
+   inline void setEagerReceive(const cardinal size);
 
    /**
      * Set send buffer size for all UDP-like associations.
@@ -514,7 +564,49 @@ class SCTPSocket
      * @param type Update condition type.
      * @return Update condition.
      */
-   inline Condition* getUpdateCondition(const UpdateConditionType type);
+   inline LeanCondition* getUpdateCondition(const UpdateConditionType type);
+
+   /**
+     * Check readiness state for given update condition type, without
+     * firing the update condition.
+     *
+     * @param type Update condition type.
+     * @return true, if ready; false otherwise.
+     */
+   inline bool isReady(const UpdateConditionType type) const;
+
+   /**
+     * Get event descriptor, which becomes readable on updates of the
+     * read, write and exception conditions of this socket. It is created
+     * on first usage and belongs to the socket. The application has to
+     * read it to reset it.
+     *
+     * @return Event descriptor or -1 in case of error.
+     */
+   int getEventFD();
+
+   /**
+     * Check, if sending to the given destination would establish a new
+     * association, i.e. the socket is in auto-connect mode and there is
+     * no association to the destination yet.
+     *
+     * @param destinationAddressList NULL-terminated destination address list.
+     * @return true, if a new association would be established; false otherwise.
+     */
+   bool wouldAutoConnect(const SocketAddress** destinationAddressList);
+
+   /**
+     * Add reference by a socket descriptor. Descriptors created by accept()
+     * and peeloff share the SCTPSocket of their parent descriptor.
+     */
+   void addDescriptorReference();
+
+   /**
+     * Remove reference by a socket descriptor.
+     *
+     * @return true, if this has been the last reference; false otherwise.
+     */
+   bool removeDescriptorReference();
 
 
    // ====== Protected data =================================================
@@ -523,7 +615,8 @@ class SCTPSocket
                                                    const bool activeOnly = true);
    int getErrorCode(const unsigned int assocID);
    int internalReceive(SCTPNotificationQueue& queue,
-                       char*                  buffer,
+                       const struct iovec*    iov,
+                       const size_t           iovlen,
                        size_t&                bufferSize,
                        int&                   flags,
                        unsigned int&          assocID,
@@ -532,6 +625,8 @@ class SCTPSocket
                        uint16_t&              ssn,
                        uint32_t&              tsn,
                        SocketAddress**        address,
+                       sockaddr*              systemAddress,
+                       socklen_t*             systemAddressLength,
                        const unsigned int     notificationFlags);
    int internalSend(const char*          buffer,
                     const size_t         length,
@@ -540,7 +635,7 @@ class SCTPSocket
                     const unsigned short streamID,
                     const unsigned int   protoID,
                     const unsigned int   timeToLive,
-                    Condition*           waitCondition,
+                    LeanCondition*       waitCondition,
                     const SocketAddress* pathDestinationAddress);
    static int getPathIndexForAddress(const unsigned int   assocID,
                                      const SocketAddress* address,
@@ -555,10 +650,11 @@ class SCTPSocket
    };
 
    SCTPNotificationQueue                         GlobalQueue;
-   Condition                                     EstablishCondition;
-   Condition                                     ReadUpdateCondition;
-   Condition                                     WriteUpdateCondition;
-   Condition                                     ExceptUpdateCondition;
+   LeanCondition                                 EstablishCondition;
+   LeanCondition                                 ReadUpdateCondition;
+   LeanCondition                                 WriteUpdateCondition;
+   LeanCondition                                 ExceptUpdateCondition;
+   EventFDCondition*                             EventFD;
 
    IncomingConnection*                           ConnectionRequests;
    std::multimap<unsigned int, SCTPAssociation*> AssociationList;
@@ -573,18 +669,20 @@ class SCTPSocket
    unsigned int                                  CorrelationID;
 
    card64                                        AutoCloseTimeout;
+   cardinal                                      EagerReceiveSize;
+   cardinal                                      DescriptorReferences;
 
 
    // ====== Private data ===================================================
    private:
    void checkAutoConnect();
-   void checkAutoClose();
+   void checkAutoClose(SCTPAssociation* association, const card64 now);
    SCTPAssociation* findAssociationForDestinationAddress(
-                       std::multimap<unsigned int, SCTPAssociation*>& list,
                        const SocketAddress** destinationAddressList);
 
 
    std::multimap<unsigned int, SCTPAssociation*> ConnectionlessAssociationList;
+   SCTPAddressIndex                              AddressIndex;
    card8                                         DefaultTrafficClass;
 
    int                                           Family;
@@ -592,9 +690,6 @@ class SCTPSocket
    bool                                          ReadReady;
    bool                                          HasException;
 
-   bool                                          AutoCloseRecursion;
-   bool                                          AutoCloseNewCheckRequired;
-
 #if (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE19)
    unsigned int                                  NoOfLocalAddresses;
    unsigned char                                 LocalAddressList[SCTP_MAX_NUM_ADDRESSES][SCTP_MAX_IP_LEN];
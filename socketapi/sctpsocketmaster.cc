@@ -53,6 +53,7 @@
 
 // #define PRINT_NOTIFICATIONS
 // #define PRINT_ARRIVENOTIFICATION
+// #define PRINT_EAGERRECEIVE
 // #define PRINT_USERCALLBACK
 // #define PRINT_ASSOC_USECOUNT
 // #define PRINT_RTOMAXRESTORE
@@ -71,9 +72,17 @@ int                              SCTPSocketMaster::GarbageCollectionTimerID = -1
 cardinal                         SCTPSocketMaster::LockLevel                = 0;
 cardinal                         SCTPSocketMaster::OldCancelState           = true;
 card64                           SCTPSocketMaster::LastGarbageCollection;
+card64                           SCTPSocketMaster::LastGarbageCollectionPause = 0;
+card64                           SCTPSocketMaster::MaxGarbageCollectionPause  = 0;
+bool                             SCTPSocketMaster::AutoCloseRecursion         = false;
+card64                           SCTPSocketMaster::NextWakeup                 = 0;
 std::set<int>                    SCTPSocketMaster::ClosingSockets;
+std::set<int>                    SCTPSocketMaster::UnusedClosingSockets;
 std::multimap<unsigned int, int> SCTPSocketMaster::ClosingAssociations;
+std::map<int, cardinal>          SCTPSocketMaster::InstanceReferences;
+std::multimap<card64, SCTPAssociation*> SCTPSocketMaster::AutoCloseQueue;
 std::multimap<int, SCTPSocket*>  SCTPSocketMaster::SocketList;
+SCTPAssociationTable             SCTPSocketMaster::AssociationTable;
 SCTP_ulpCallbacks                SCTPSocketMaster::Callbacks;
 SCTPSocketMaster                 SCTPSocketMaster::MasterInstance;
 Randomizer                       SCTPSocketMaster::Random;
@@ -81,7 +90,11 @@ int                              SCTPSocketMaster::BreakPipe[2];
 SCTPSocketMaster::UserSocketNotification
                                  SCTPSocketMaster::BreakNotification;
 
-ExtSocketDescriptor              ExtSocketDescriptorMaster::Sockets[ExtSocketDescriptorMaster::MaxSockets];
+ExtSocketDescriptor*             ExtSocketDescriptorMaster::Pages[ExtSocketDescriptorMaster::MaxPages];
+unsigned int                     ExtSocketDescriptorMaster::PageCount = 0;
+card64                           ExtSocketDescriptorMaster::FreeMap[ExtSocketDescriptorMaster::MaxPages][ExtSocketDescriptorMaster::PageSize / ExtSocketDescriptorMaster::WordBits];
+card64                           ExtSocketDescriptorMaster::FreePageMap[ExtSocketDescriptorMaster::MaxPages / ExtSocketDescriptorMaster::WordBits];
+Synchronizable                   ExtSocketDescriptorMaster::TableLock("ExtSocketDescriptorMaster::TableLock", false);
 ExtSocketDescriptorMaster        ExtSocketDescriptorMaster::MasterInstance;
 
 
@@ -252,7 +265,7 @@ SCTPSocketMaster::~SCTPSocketMaster()
    unlock();
 
    // ====== Do garbage collection for sockets ==============================
-   socketGarbageCollection();
+   socketGarbageCollection(true);
 
    // ====== Wait for thread to finish ======================================
    join();
@@ -276,12 +289,19 @@ SCTPSocketMaster::~SCTPSocketMaster()
 void SCTPSocketMaster::run()
 {
    for(;;) {
-      card64 now         = getMicroTime();
-      const card64 usecs =
-         (LastGarbageCollection + GarbageCollectionInterval > now) ?
-             (LastGarbageCollection + GarbageCollectionInterval - now) : 0;
-
       MasterInstance.lock();
+
+      // ====== Wake up for next garbage collection or auto-close ===========
+      // An unfinished collection is continued immediately.
+      card64 now      = getMicroTime();
+      card64 deadline = (UnusedClosingSockets.empty()) ?
+                           (LastGarbageCollection + GarbageCollectionInterval) : now;
+      if((!AutoCloseQueue.empty()) && (AutoCloseQueue.begin()->first < deadline)) {
+         deadline = AutoCloseQueue.begin()->first;
+      }
+      const card64 usecs = (deadline > now) ? (deadline - now) : 0;
+      NextWakeup = deadline;
+
       GarbageCollectionTimerID = sctp_startTimer((unsigned int)(usecs / 1000000),
                                                  (unsigned int)(usecs % 1000000),
                                                  timerCallback, NULL, NULL);
@@ -292,10 +312,12 @@ void SCTPSocketMaster::run()
       MasterInstance.lock();
       sctp_stopTimer(GarbageCollectionTimerID);
       GarbageCollectionTimerID = -1;
+      autoCloseCollection();
       MasterInstance.unlock();
 
       now = getMicroTime();
-      if(now - LastGarbageCollection >= GarbageCollectionInterval) {
+      if((!UnusedClosingSockets.empty()) ||
+         (now - LastGarbageCollection >= GarbageCollectionInterval)) {
          socketGarbageCollection();
       }
    }
@@ -363,6 +385,23 @@ bool SCTPSocketMaster::enableCRC32(const bool enable)
 }
 
 
+// ###### Get garbage collection pause times ###############################
+void SCTPSocketMaster::getGarbageCollectionPause(card64& lastPause, card64& maxPause)
+{
+   MasterInstance.lock();
+   lastPause = LastGarbageCollectionPause;
+   maxPause  = MaxGarbageCollectionPause;
+   MasterInstance.unlock();
+}
+
+
+// ###### Get notification pool statistics ##################################
+void SCTPSocketMaster::getNotificationPoolStatistics(SCTPNotificationPool::Statistics& statistics)
+{
+   SCTPNotificationQueue::getPool()->getStatistics(statistics);
+}
+
+
 // ###### Add AssociationID to be deleted ###################################
 void SCTPSocketMaster::delayedDeleteAssociation(const unsigned short instanceID,
                                                 const unsigned int   assocID)
@@ -371,6 +410,7 @@ void SCTPSocketMaster::delayedDeleteAssociation(const unsigned short instanceID,
    std::cout << "delayedDeleteAssociation: A=" << assocID << " I=" << instanceID << std::endl;
 #endif
    ClosingAssociations.insert(std::pair<unsigned int, unsigned short>(assocID,instanceID));
+   InstanceReferences[instanceID]++;
 }
 
 
@@ -380,65 +420,130 @@ void SCTPSocketMaster::delayedDeleteSocket(const unsigned short instanceID)
 #ifdef PRINT_GC
    std::cout << "delayedDeleteSocket: I=" << instanceID << std::endl;
 #endif
-   ClosingSockets.insert(instanceID);
+   if(InstanceReferences.find(instanceID) == InstanceReferences.end()) {
+      UnusedClosingSockets.insert(instanceID);
+   }
+   else {
+      ClosingSockets.insert(instanceID);
+   }
 }
 
 
-// ###### Try to delete instance ############################################
-void SCTPSocketMaster::socketGarbageCollection()
+// ###### Release reference of closing association to instance #############
+void SCTPSocketMaster::releaseInstance(const int instanceID)
 {
-#ifdef PRINT_GC
-   std::cout << "Socket garbage collection..." << std::endl;
-#endif
-   MasterInstance.lock();
-   LastGarbageCollection = getMicroTime();
-
-   // ====== Try to auto-close connectionless associations ==================
-   std::multimap<int, SCTPSocket*>::iterator socketIterator = SocketList.begin();
-   while(socketIterator != SCTPSocketMaster::SocketList.end()) {
-      SCTPSocket* socket = socketIterator->second;
-      socket->checkAutoClose();
-      socketIterator++;
-   }
-
-   // ====== Try to delete already removed sockets using sctplib ============
-   std::set<int>::iterator iterator = ClosingSockets.begin();
-   while(iterator != ClosingSockets.end()) {
-      const unsigned short instanceID = *iterator;
-
-      bool used = false;
-      std::multimap<unsigned int, int>::iterator assocIterator = ClosingAssociations.begin();
-      while(assocIterator != ClosingAssociations.end()) {
-         if(instanceID == assocIterator->second) {
-            used = true;
-            break;
+   std::map<int, cardinal>::iterator found = InstanceReferences.find(instanceID);
+   if(found != InstanceReferences.end()) {
+      found->second--;
+      if(found->second == 0) {
+         InstanceReferences.erase(found);
+         // The last closing association is gone. If the socket itself has
+         // already been closed, the instance may be unregistered now.
+         if(ClosingSockets.erase(instanceID) > 0) {
+            unregisterInstance(instanceID);
          }
-         assocIterator++;
       }
+   }
+}
 
-      if(!used) {
+
+// ###### Unregister instance from sctplib ##################################
+void SCTPSocketMaster::unregisterInstance(const int instanceID)
+{
 #ifdef PRINT_GC
-         std::cout << "socketGarbageCollection: Removing instance #" << instanceID << "." << std::endl;
+   std::cout << "unregisterInstance: Removing instance #" << instanceID << "." << std::endl;
 #endif
-         iterator++;
-         ClosingSockets.erase(instanceID);
-         if(sctp_unregisterInstance(instanceID) != SCTP_SUCCESS) {
+   if(sctp_unregisterInstance((unsigned short)instanceID) != SCTP_SUCCESS) {
 #ifndef DISABLE_WARNINGS
-            std::cerr << "INTERNAL ERROR: SCTPSocketMaster::socketGarbageCollection() - sctp_unregisterInstance() failed!" << std::endl;
+      std::cerr << "INTERNAL ERROR: SCTPSocketMaster::unregisterInstance() - sctp_unregisterInstance() failed!" << std::endl;
 #endif
-            ::abort();
-         }
-      }
-      else {
-         iterator++;
-      }
+      ::abort();
+   }
+}
+
+
+// ###### Schedule auto-close check of association #########################
+void SCTPSocketMaster::scheduleAutoClose(SCTPAssociation* association,
+                                         const card64     deadline)
+{
+   if(association->AutoCloseQueued) {
+      AutoCloseQueue.erase(association->AutoCloseEntry);
    }
+   association->AutoCloseEntry  = AutoCloseQueue.insert(
+                                     std::pair<const card64, SCTPAssociation*>(deadline, association));
+   association->AutoCloseQueued = true;
 
-   MasterInstance.unlock();
+   // ====== Wake up master thread for an earlier deadline ==================
+   if((deadline < NextWakeup) && (BreakPipe[0] != -1)) {
+      NextWakeup = deadline;
+      char dummy = 'T';
+      dummy = write(BreakPipe[1],&dummy,sizeof(dummy));
+   }
+}
+
+
+// ###### Cancel auto-close check of association ############################
+void SCTPSocketMaster::unscheduleAutoClose(SCTPAssociation* association)
+{
+   if(association->AutoCloseQueued) {
+      AutoCloseQueue.erase(association->AutoCloseEntry);
+      association->AutoCloseQueued = false;
+   }
+}
+
+
+// ###### Check associations with due auto-close deadline ###################
+void SCTPSocketMaster::autoCloseCollection()
+{
+   // The closing callbacks of abort() and shutdown() call this function
+   // again. Associations scheduled by them are handled by the outer loop.
+   if(AutoCloseRecursion) {
+      return;
+   }
+   AutoCloseRecursion = true;
+
+   const card64 now = getMicroTime();
+   while((!AutoCloseQueue.empty()) && (AutoCloseQueue.begin()->first <= now)) {
+      SCTPAssociation* association = AutoCloseQueue.begin()->second;
+      AutoCloseQueue.erase(AutoCloseQueue.begin());
+      association->AutoCloseQueued = false;
+      association->Socket->checkAutoClose(association, now);
+   }
+
+   AutoCloseRecursion = false;
+}
+
+
+// ###### Garbage collection step ###########################################
+void SCTPSocketMaster::socketGarbageCollection(const bool complete)
+{
+#ifdef PRINT_GC
+   std::cout << "Socket garbage collection..." << std::endl;
+#endif
+   MasterInstance.lock();
+   const card64 start = getMicroTime();
+   LastGarbageCollection = start;
+
+   // ====== Unregister instances not used by closing associations ==========
+   cardinal removed = 0;
+   while( (!UnusedClosingSockets.empty()) &&
+          ((complete) || (removed < GarbageCollectionBatchSize)) ) {
+      const int instanceID = *(UnusedClosingSockets.begin());
+      UnusedClosingSockets.erase(UnusedClosingSockets.begin());
+      unregisterInstance(instanceID);
+      removed++;
+   }
+
+   // ====== Update pause time statistics ===================================
+   LastGarbageCollectionPause = getMicroTime() - start;
+   if(LastGarbageCollectionPause > MaxGarbageCollectionPause) {
+      MaxGarbageCollectionPause = LastGarbageCollectionPause;
+   }
 #ifdef PRINT_GC
-   std::cout << "Socket garbage collection completed in "
-             << getMicroTime() - LastGarbageCollection << " s" << std::endl;
+   std::cout << "Socket garbage collection step completed in "
+             << LastGarbageCollectionPause << " us: removed=" << removed << std::endl;
 #endif
+   MasterInstance.unlock();
 }
 
 
@@ -467,9 +572,11 @@ bool SCTPSocketMaster::associationGarbageCollection(const unsigned int assocID,
 #endif
          ::abort();
       }
+      const int instanceID = iterator->second;
       ClosingAssociations.erase(iterator);
 
-      socketGarbageCollection();
+      // ====== Release instance ============================================
+      releaseInstance(instanceID);
       return(true);
    }
    return(false);
@@ -497,17 +604,17 @@ void SCTPSocketMaster::dataArriveNotif(unsigned int   assocID,
 
    SCTPSocket* socket = getSocketForAssociationID(assocID);
    if(socket != NULL) {
-      SCTPNotification notification;
-      initNotification(notification, assocID, streamID);
-      sctp_data_arrive* sda = &notification.Content.sn_data_arrive;
-      sda->sda_type          = SCTP_DATA_ARRIVE;
-      sda->sda_flags         = (unordered == 1) ? SCTP_ARRIVE_UNORDERED : 0;
-      sda->sda_length        = sizeof(sctp_data_arrive);
-      sda->sda_assoc_id      = assocID;
-      sda->sda_stream        = streamID;
-      sda->sda_ppid          = protoID;
-      sda->sda_bytes_arrived = length;
-      addNotification(socket,assocID,notification);
+      // The remote addresses are not copied for data arrival. They are
+      // available from the association's path cache.
+      sctp_data_arrive sda;
+      sda.sda_type          = SCTP_DATA_ARRIVE;
+      sda.sda_flags         = (unordered == 1) ? SCTP_ARRIVE_UNORDERED : 0;
+      sda.sda_length        = sizeof(sctp_data_arrive);
+      sda.sda_assoc_id      = assocID;
+      sda.sda_stream        = streamID;
+      sda.sda_ppid          = protoID;
+      sda.sda_bytes_arrived = length;
+      addDataArrive(socket,assocID,sda);
    }
 }
 
@@ -531,7 +638,8 @@ void SCTPSocketMaster::sendFailureNotif(unsigned int   assocID,
    SCTPSocket* socket = getSocketForAssociationID(assocID);
    if(socket != NULL) {
       SCTPNotification notification;
-      initNotification(notification, assocID, 0);
+      initNotification(notification,
+                       socket->getAssociationForAssociationID(assocID,false));
       sctp_send_failed* ssf = &notification.Content.sn_send_failed;
       ssf->ssf_type     = SCTP_REMOTE_ERROR;
       ssf->ssf_flags    = 0;
@@ -607,8 +715,14 @@ void SCTPSocketMaster::networkStatusChangeNotif(unsigned int assocID,
    // ====== Generate "Network Status Change" notification ==================
    SCTPSocket* socket = getSocketForAssociationID(assocID);
    if(socket != NULL) {
+      // ====== Refresh path cache ==========================================
+      SCTPAssociation* association = socket->getAssociationForAssociationID(assocID,false);
+      if(association != NULL) {
+         association->updatePathCache();
+      }
+
       SCTPNotification notification;
-      initNotification(notification, assocID, 0);
+      initNotification(notification, association);
       sctp_paddr_change* spc = &notification.Content.sn_paddr_change;
       spc->spc_type     = SCTP_PEER_ADDR_CHANGE;
       spc->spc_flags    = 0;
@@ -689,7 +803,7 @@ void* SCTPSocketMaster::communicationUpNotif(unsigned int   assocID,
 {
    SCTPAssociation* association = NULL;
    SCTPNotification notification;
-   initNotification(notification, assocID, 0);
+   initNotification(notification);
 
 #ifdef PRINT_NOTIFICATIONS
    char str[256];
@@ -719,6 +833,9 @@ void* SCTPSocketMaster::communicationUpNotif(unsigned int   assocID,
             association->RTOMaxIsInitTimeout = false;
          }
 
+         association->updatePathCache();
+         initNotification(notification, association);
+
          association->CommunicationUpNotification = true;
          association->EstablishCondition.broadcast();
          association->WriteReady   = true;
@@ -735,6 +852,9 @@ void* SCTPSocketMaster::communicationUpNotif(unsigned int   assocID,
          association = new SCTPAssociation(socket, assocID, socket->NotificationFlags,
                                            socket->Flags & SCTPSocket::SSF_GlobalQueue);
          if(association != NULL) {
+            association->updatePathCache();
+            initNotification(notification, association);
+
             association->CommunicationUpNotification = true;
             SCTPSocket::IncomingConnection* newConnection = new SCTPSocket::IncomingConnection;
             if(newConnection != NULL) {
@@ -755,6 +875,12 @@ void* SCTPSocketMaster::communicationUpNotif(unsigned int   assocID,
 
                socket->ReadReady = true;
                socket->EstablishCondition.broadcast();
+
+               // Receivers of an auto-connect socket wait for the global
+               // queue; they have to accept the new association.
+               if(socket->Flags & SCTPSocket::SSF_AutoConnect) {
+                  socket->GlobalQueue.signal();
+               }
             }
             association->WriteReady   = true;
             association->HasException = false;
@@ -880,7 +1006,14 @@ void SCTPSocketMaster::communicationLostNotif(unsigned int assocID,
          association->EstablishCondition.broadcast();
          association->ReadyForTransmit.broadcast();
       }
-      socket->checkAutoClose();
+
+      // ====== Remove closed connectionless association ====================
+      // Connectionless associations are always queued, except while being
+      // checked by SCTPSocket::checkAutoClose(), which reschedules them.
+      if((association != NULL) && (association->AutoCloseQueued)) {
+         scheduleAutoClose(association, 0);
+      }
+      autoCloseCollection();
    }
 }
 
@@ -910,7 +1043,8 @@ void SCTPSocketMaster::communicationErrorNotif(unsigned int assocID,
    SCTPSocket* socket = getSocketForAssociationID(assocID);
    if(socket != NULL) {
       SCTPNotification notification;
-      initNotification(notification, assocID, 0);
+      initNotification(notification,
+                       socket->getAssociationForAssociationID(assocID,false));
       sctp_remote_error* sre = &notification.Content.sn_remote_error;
       sre->sre_type      = SCTP_REMOTE_ERROR;
       sre->sre_flags     = 0;
@@ -936,6 +1070,13 @@ void SCTPSocketMaster::restartNotif(unsigned int assocID, void* ulpDataPtr)
    // ====== Generate "Restart" notification ==================================
    SCTPSocket* socket = getSocketForAssociationID(assocID);
    if(socket != NULL) {
+      // ====== Refresh path cache ==========================================
+      // The restarted peer may use a different set of addresses.
+      SCTPAssociation* association = socket->getAssociationForAssociationID(assocID,false);
+      if(association != NULL) {
+         association->updatePathCache();
+      }
+
       SCTPNotification notification;
       initNotification(notification);
       sctp_assoc_change* sac = &notification.Content.sn_assoc_change;
@@ -1032,7 +1173,14 @@ void SCTPSocketMaster::shutdownCompleteNotif(unsigned int assocID, void* ulpData
          sac->sac_assoc_id         = assocID;
          addNotification(socket,assocID,notification);
       }
-      socket->checkAutoClose();
+
+      // ====== Remove closed connectionless association ====================
+      // Connectionless associations are always queued, except while being
+      // checked by SCTPSocket::checkAutoClose(), which reschedules them.
+      if((association != NULL) && (association->AutoCloseQueued)) {
+         scheduleAutoClose(association, 0);
+      }
+      autoCloseCollection();
    }
 }
 
@@ -1079,6 +1227,15 @@ void SCTPSocketMaster::asconfStatusNotif(unsigned int assocID,
                assocID,correlationID,result);
    std::cerr << str << std::endl;
 #endif
+
+   // ====== Refresh path cache =============================================
+   SCTPSocket* socket = getSocketForAssociationID(assocID);
+   if(socket != NULL) {
+      SCTPAssociation* association = socket->getAssociationForAssociationID(assocID,false);
+      if(association != NULL) {
+         association->updatePathCache();
+      }
+   }
 }
 #endif
 
@@ -1126,6 +1283,13 @@ void SCTPSocketMaster::userCallback(int        fileDescriptor,
 // ###### Get socket for given association ID ###############################
 SCTPSocket* SCTPSocketMaster::getSocketForAssociationID(const unsigned int assocID)
 {
+   // ====== Look up association table ======================================
+   const SCTPAssociationTable::Entry* entry = AssociationTable.find(assocID);
+   if(entry != NULL) {
+      return(entry->Socket);
+   }
+
+   // ====== No association object (yet) -> ask sctplib =====================
 #if (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE19) || (SCTPLIB_VERSION == SCTPLIB_1_0_0)
    unsigned short instanceID = 0;
 #elif (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE20) || (SCTPLIB_VERSION == SCTPLIB_1_3_0)
@@ -1172,54 +1336,26 @@ void SCTPSocketMaster::initNotification(SCTPNotification& notification)
 }
 
 
-// ###### Initialize SCTPNotification structure #############################
-bool SCTPSocketMaster::initNotification(SCTPNotification& notification,
-                                        unsigned int      assocID,
-                                        unsigned short    streamID)
+// ###### Initialize SCTPNotification structure from path cache ############
+void SCTPSocketMaster::initNotification(SCTPNotification& notification,
+                                        SCTPAssociation*  association)
 {
    notification.Content.sn_header.sn_type = SCTP_UNDEFINED;
    notification.ContentPosition = 0;
-   SCTP_Association_Status status;
-   if(sctp_getAssocStatus(assocID, &status) == 0) {
-      notification.RemotePort      = status.destPort;
-#if (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE19) || (SCTPLIB_VERSION == SCTPLIB_1_0_0)
-      notification.RemoteAddresses = std::min((unsigned short)SCTP_MAX_NUM_ADDRESSES,
-                                              status.numberOfAddresses);
-#elif (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE20) || (SCTPLIB_VERSION == SCTPLIB_1_3_0)
-      notification.RemoteAddresses = std::min((unsigned short)SCTP_MAX_NUM_ADDRESSES,
-                                              status.numberOfDestinationPaths);
-#else
-#error Wrong sctplib version!
-#endif
-      for(unsigned int i = 0;i < notification.RemoteAddresses;i++) {
-         SCTP_Path_Status pathStatus;
-#if (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE19) || (SCTPLIB_VERSION == SCTPLIB_1_0_0)
-         if(sctp_getPathStatus(assocID,i,&pathStatus) != 0) {
-#elif (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE20) || (SCTPLIB_VERSION == SCTPLIB_1_3_0)
-         if(sctp_getPathStatus(assocID,status.destinationPathIDs[i],&pathStatus) != 0) {
-#else
-#error Wrong sctplib version!
-#endif
-
-#ifndef DISABLE_WARNINGS
-            std::cerr << "WARNING: SCTPSocketMaster::initNotification() - sctp_getPathStatus() failure!"
-                      << std::endl;
-#endif
-
-         }
-         else {
-            memcpy((char*)&notification.RemoteAddress[i],
-                   (char*)&pathStatus.destinationAddress,
-                   sizeof(pathStatus.destinationAddress));
-         }
+   if( (association != NULL) &&
+       ((association->PathCacheValid) || (association->updatePathCache())) ) {
+      notification.RemotePort      = association->RemotePort;
+      notification.RemoteAddresses = association->RemotePaths;
+      memcpy((char*)&notification.RemoteAddress,
+             (char*)&association->RemotePathAddress,
+             association->RemotePaths * sizeof(association->RemotePathAddress[0]));
+      for(unsigned int i = association->RemotePaths;i < SCTP_MAX_NUM_ADDRESSES;i++) {
+         notification.RemoteAddress[i][0] = 0x00;
       }
-      return(true);
    }
-#ifndef DISABLE_WARNINGS
-         std::cerr << "WARNING: SCTPSocketMaster::initNotification() - sctp_getAssocStatus() failure!"
-                   << std::endl;
-#endif
-   return(false);
+   else {
+      initNotification(notification);
+   }
 }
 
 
@@ -1237,8 +1373,7 @@ void SCTPSocketMaster::addNotification(SCTPSocket*             socket,
    const unsigned int notificationFlags = association->NotificationFlags;
 
    // ====== Check, if notification has to be added =========================
-   if((notification.Content.sn_header.sn_type == SCTP_DATA_ARRIVE)    ||
-      ((notification.Content.sn_header.sn_type == SCTP_ASSOC_CHANGE)     && (notificationFlags & SCTP_RECVASSOCEVNT))    ||
+   if(((notification.Content.sn_header.sn_type == SCTP_ASSOC_CHANGE)     && (notificationFlags & SCTP_RECVASSOCEVNT))    ||
       ((notification.Content.sn_header.sn_type == SCTP_PEER_ADDR_CHANGE) && (notificationFlags & SCTP_RECVPADDREVNT))    ||
       ((notification.Content.sn_header.sn_type == SCTP_REMOTE_ERROR)     && (notificationFlags & SCTP_RECVPEERERR))      ||
       ((notification.Content.sn_header.sn_type == SCTP_SEND_FAILED)      && (notificationFlags & SCTP_RECVSENDFAILEVNT)) ||
@@ -1277,6 +1412,131 @@ void SCTPSocketMaster::addNotification(SCTPSocket*             socket,
 }
 
 
+// ###### Add data arrival to socket's queue ################################
+void SCTPSocketMaster::addDataArrive(SCTPSocket*             socket,
+                                     unsigned int            assocID,
+                                     const sctp_data_arrive& dataArrive)
+{
+   SCTPAssociation* association = socket->getAssociationForAssociationID(assocID, false);
+   if(association == NULL) {
+      // Association not found -> already closed.
+      return;
+   }
+
+   association->UseCount++;
+#ifdef PRINT_ASSOC_USECOUNT
+   std::cout << association->UseCount << ". Data Arrive" << std::endl;
+#endif
+
+   // ====== Eager receive mode: copy message into receive ring =============
+   sctp_data_arrive sda      = dataArrive;
+   const bool       buffered = eagerReceive(association,sda);
+   if(!buffered) {
+      association->UnbufferedArrivals++;
+   }
+
+   // ====== Add data arrival to global or association's queue ==============
+   if( (socket->Flags & SCTPSocket::SSF_GlobalQueue) &&
+       (association->PeeledOff == false) ) {
+      socket->GlobalQueue.addDataArrive(sda,buffered);
+      socket->ReadReady = true;
+   }
+   else {
+      association->InQueue.addDataArrive(sda,buffered);
+      association->ReadReady = true;
+   }
+}
+
+
+// ###### Copy arrived message into association's receive ring #############
+bool SCTPSocketMaster::eagerReceive(SCTPAssociation*  association,
+                                    sctp_data_arrive& dataArrive)
+{
+   const cardinal ringSize = association->Socket->EagerReceiveSize;
+   if(ringSize == 0) {
+      return(false);
+   }
+
+   // sctp_receive() takes the head of the stream's data in sctplib. If
+   // messages of previous data arrivals are still left in sctplib, they
+   // would be taken instead of the new one. Therefore, eager buffering
+   // is paused until the receiver has taken all of them.
+   if(association->UnbufferedArrivals > 0) {
+#ifdef PRINT_EAGERRECEIVE
+      std::cout << "EagerReceive: " << association->UnbufferedArrivals
+                << " unbuffered messages pending for A" << association->getID() << std::endl;
+#endif
+      return(false);
+   }
+   if(association->ReceiveRing == NULL) {
+      association->ReceiveRing = new SCTPMessageRing(ringSize);
+      if(association->ReceiveRing == NULL) {
+         return(false);
+      }
+   }
+
+   // ====== Reserve space; otherwise, the message remains in sctplib =======
+   char* data = association->ReceiveRing->reserve(dataArrive.sda_bytes_arrived);
+   if(data == NULL) {
+#ifdef PRINT_EAGERRECEIVE
+      std::cout << "EagerReceive: no space for " << dataArrive.sda_bytes_arrived
+                << " bytes in ring of A" << association->getID() << std::endl;
+#endif
+      return(false);
+   }
+
+   // ====== Receive message ================================================
+   SCTPMessageRing::Record record;
+   unsigned int            receivedBytes = dataArrive.sda_bytes_arrived;
+#if (SCTPLIB_VERSION == SCTPLIB_1_0_0)
+   unsigned int pathIndex;
+   const int ok = sctp_receivefrom(dataArrive.sda_assoc_id, dataArrive.sda_stream,
+                                   (unsigned char*)data,
+                                   &receivedBytes,
+                                   &record.SSN,
+                                   &record.TSN,
+                                   &pathIndex,
+                                   SCTP_MSG_DEFAULT);
+#elif (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE19) || (SCTPLIB_VERSION == SCTPLIB_1_0_0_PRE20) || (SCTPLIB_VERSION == SCTPLIB_1_3_0)
+   const int ok = sctp_receive(dataArrive.sda_assoc_id, dataArrive.sda_stream,
+                               (unsigned char*)data,
+                               &receivedBytes,
+                               &record.SSN,
+                               &record.TSN,
+                               SCTP_MSG_DEFAULT);
+   const int pathIndex = sctp_getPrimary(dataArrive.sda_assoc_id);
+#else
+#error Wrong sctplib version!
+#endif
+   if(ok != 0) {
+#ifndef DISABLE_WARNINGS
+      std::cerr << "WARNING: SCTPSocketMaster::eagerReceive() - sctp_receive() failed!" << std::endl;
+#endif
+      return(false);
+   }
+
+   // ====== Append message to ring =========================================
+   record.Length           = receivedBytes;
+   record.StreamID         = dataArrive.sda_stream;
+   const sockaddr* remoteAddress =
+      association->getPathSystemAddress((unsigned int)pathIndex, record.RemoteAddressLength);
+   if((remoteAddress != NULL) && (record.RemoteAddressLength <= sizeof(record.RemoteAddress))) {
+      memcpy((char*)&record.RemoteAddress, remoteAddress, record.RemoteAddressLength);
+   }
+   else {
+      record.RemoteAddressLength = 0;
+   }
+   association->ReceiveRing->commit(record);
+   dataArrive.sda_bytes_arrived = receivedBytes;
+
+#ifdef PRINT_EAGERRECEIVE
+   std::cout << "EagerReceive: " << receivedBytes << " bytes for A" << association->getID()
+             << " (" << association->ReceiveRing->count() << " messages in ring)" << std::endl;
+#endif
+   return(true);
+}
+
+
 // ###### Add user socket notification ######################################
 void SCTPSocketMaster::addUserSocketNotification(UserSocketNotification* usn)
 {
@@ -42,6 +42,8 @@
 #include "thread.h"
 #include "sctpsocket.h"
 #include "sctpnotificationqueue.h"
+#include "sctpnotificationpool.h"
+#include "sctpassociationtable.h"
 #include "randomizer.h"
 
 
@@ -63,6 +65,14 @@
   * userland SCTP implementation. It is implemented as a singleton and
   * automatically instantiated at program startup.
   *
+  * Lock hierarchy (outer to inner):
+  * 1. SCTPSocketMaster lock: required for all sctplib calls and held by
+  *    the sctplib callbacks.
+  * 2. SCTPNotificationQueue lock and SCTPAssociationTable lock.
+  * 3. SCTPNotificationPool lock, Condition locks and the descriptor table
+  *    lock of ExtSocketDescriptorMaster.
+  * A lock must never be obtained while holding a lock of a higher level.
+  *
   * @short   SCTP Socket Master
   * @author  Thomas Dreibholz (thomas.dreibholz@gmail.com)
   * @version 1.0
@@ -146,6 +156,25 @@ class SCTPSocketMaster : public Thread
    static bool enableCRC32(const bool enable);
 
 
+   // ====== Statistics =====================================================
+   /**
+     * Get the pause times of the garbage collection, i.e. the time the
+     * master lock has been held by a single collection step.
+     *
+     * @param lastPause Reference to store duration of last step in microseconds.
+     * @param maxPause Reference to store maximum duration in microseconds.
+     */
+   static void getGarbageCollectionPause(card64& lastPause, card64& maxPause);
+
+   /**
+     * Get the allocation statistics of the pool for the entries and
+     * notifications of all notification queues.
+     *
+     * @param statistics Reference to store statistics to.
+     */
+   static void getNotificationPoolStatistics(SCTPNotificationPool::Statistics& statistics);
+
+
    // ====== Public data ====================================================
    public:
    /**
@@ -171,21 +200,33 @@ class SCTPSocketMaster : public Thread
    static cardinal                         LockLevel;
    static SCTP_ulpCallbacks                Callbacks;
    static std::multimap<int, SCTPSocket*>  SocketList;
+   static SCTPAssociationTable             AssociationTable;
    static std::set<int>                    ClosingSockets;
+   static std::set<int>                    UnusedClosingSockets;
    static std::multimap<unsigned int, int> ClosingAssociations;
+   static std::map<int, cardinal>          InstanceReferences;
    static card64                           LastGarbageCollection;
+   static card64                           LastGarbageCollectionPause;
+   static card64                           MaxGarbageCollectionPause;
+   static std::multimap<card64, SCTPAssociation*> AutoCloseQueue;
+   static bool                             AutoCloseRecursion;
+   static card64                           NextWakeup;
    static cardinal                         OldCancelState;
    static int                              BreakPipe[2];
    static int                              GarbageCollectionTimerID;
    static UserSocketNotification           BreakNotification;
 
    static const card64                     GarbageCollectionInterval = 1000000;
+   static const cardinal                   GarbageCollectionBatchSize = 256;
 
 
    static SCTPSocket* getSocketForAssociationID(const unsigned int assocID);
    static void delayedDeleteAssociation(const unsigned short instanceID,
                                         const unsigned int assocID);
    static void delayedDeleteSocket(const unsigned short instanceID);
+   static void scheduleAutoClose(SCTPAssociation* association,
+                                 const card64     deadline);
+   static void unscheduleAutoClose(SCTPAssociation* association);
 
 
    // ====== Private data ===================================================
@@ -194,17 +235,24 @@ class SCTPSocketMaster : public Thread
    static void lock(void* data);
    static void unlock(void* data);
 
-   static void socketGarbageCollection();
+   static void socketGarbageCollection(const bool complete = false);
+   static void autoCloseCollection();
+   static void releaseInstance(const int instanceID);
+   static void unregisterInstance(const int instanceID);
    static bool associationGarbageCollection(const unsigned int assocID,
                                             const bool         sendAbort);
 
    static void initNotification(SCTPNotification& notification);
-   static bool initNotification(SCTPNotification& notification,
-                                unsigned int      assocID,
-                                unsigned short    streamID);
+   static void initNotification(SCTPNotification& notification,
+                                SCTPAssociation*  association);
    static void addNotification(SCTPSocket*             socket,
                                unsigned int            assocID,
                                const SCTPNotification& notification);
+   static void addDataArrive(SCTPSocket*             socket,
+                             unsigned int            assocID,
+                             const sctp_data_arrive& dataArrive);
+   static bool eagerReceive(SCTPAssociation*  association,
+                            sctp_data_arrive& dataArrive);
 
    static void dataArriveNotif(unsigned int   assocID,
                                unsigned short streamID,
@@ -62,6 +62,8 @@
 #include "sctpsocketmaster.h"
 #include "sctpsocket.h"
 #include "sctpassociation.h"
+#include "extepoll.h"
+#include "tools.h"
 
 
 #include <sys/time.h>
@@ -176,62 +178,188 @@ static sockaddr* pack_sockaddr_storage(const sockaddr_storage* addrArray, const
 // ###### Constructor #######################################################
 ExtSocketDescriptorMaster::ExtSocketDescriptorMaster()
 {
-   for(unsigned int i = 0;i < MaxSockets;i++) {
-      Sockets[i].Type = ExtSocketDescriptor::ESDT_Invalid;
-   }
-   if(STDIN_FILENO < MaxSockets) {
-      Sockets[STDIN_FILENO].Type                   = ExtSocketDescriptor::ESDT_System;
-      Sockets[STDIN_FILENO].Socket.SystemSocketID  = STDIN_FILENO;
-   }
-   if(STDOUT_FILENO < MaxSockets) {
-      Sockets[STDOUT_FILENO].Type                  = ExtSocketDescriptor::ESDT_System;
-      Sockets[STDOUT_FILENO].Socket.SystemSocketID = STDOUT_FILENO;
-   }
-   if(STDERR_FILENO < MaxSockets) {
-      Sockets[STDERR_FILENO].Type                  = ExtSocketDescriptor::ESDT_System;
-      Sockets[STDERR_FILENO].Socket.SystemSocketID = STDERR_FILENO;
-   }
+   TableLock.synchronized();
+   if(PageCount == 0) {
+      allocatePage();
+   }
+   if(Pages[0][STDIN_FILENO].Type == ExtSocketDescriptor::ESDT_Invalid) {
+      Pages[0][STDIN_FILENO].Type                   = ExtSocketDescriptor::ESDT_System;
+      Pages[0][STDIN_FILENO].Socket.SystemSocketID  = STDIN_FILENO;
+      markUsed(STDIN_FILENO);
+   }
+   if(Pages[0][STDOUT_FILENO].Type == ExtSocketDescriptor::ESDT_Invalid) {
+      Pages[0][STDOUT_FILENO].Type                  = ExtSocketDescriptor::ESDT_System;
+      Pages[0][STDOUT_FILENO].Socket.SystemSocketID = STDOUT_FILENO;
+      markUsed(STDOUT_FILENO);
+   }
+   if(Pages[0][STDERR_FILENO].Type == ExtSocketDescriptor::ESDT_Invalid) {
+      Pages[0][STDERR_FILENO].Type                  = ExtSocketDescriptor::ESDT_System;
+      Pages[0][STDERR_FILENO].Socket.SystemSocketID = STDERR_FILENO;
+      markUsed(STDERR_FILENO);
+   }
+   TableLock.unsynchronized();
 }
 
 
 // ###### Destructor ########################################################
 ExtSocketDescriptorMaster::~ExtSocketDescriptorMaster()
 {
-   for(unsigned int i = 0;i < MaxSockets;i++) {
-      if((Sockets[i].Type != ExtSocketDescriptor::ESDT_Invalid) &&
+   for(unsigned int i = 0;i < getSocketLimit();i++) {
+      if((getSocket(i)->Type != ExtSocketDescriptor::ESDT_Invalid) &&
          (i != STDIN_FILENO)  &&
          (i != STDOUT_FILENO) &&
          (i != STDERR_FILENO)) {
          ext_close(i);
       }
    }
+   // The pages are not freed here, since other static objects may still
+   // look up descriptors during their destruction.
+}
+
+
+// ###### Get number of highest bit set #####################################
+static inline unsigned int highestBit(const card64 value)
+{
+   return(63 - __builtin_clzll((unsigned long long)value));
+}
+
+
+// ###### Mark slot as used #################################################
+void ExtSocketDescriptorMaster::markUsed(const unsigned int id)
+{
+   const unsigned int page = id / PageSize;
+   const unsigned int slot = id % PageSize;
+   FreeMap[page][slot / WordBits] &= ~((card64)1 << (slot % WordBits));
+   for(unsigned int i = 0;i < PageSize / WordBits;i++) {
+      if(FreeMap[page][i] != 0) {
+         return;
+      }
+   }
+   FreePageMap[page / WordBits] &= ~((card64)1 << (page % WordBits));
+}
+
+
+// ###### Mark slot as free #################################################
+void ExtSocketDescriptorMaster::markFree(const unsigned int id)
+{
+   const unsigned int page = id / PageSize;
+   const unsigned int slot = id % PageSize;
+   FreeMap[page][slot / WordBits] |= (card64)1 << (slot % WordBits);
+   FreePageMap[page / WordBits]   |= (card64)1 << (page % WordBits);
+}
+
+
+// ###### Get number of lowest bit set ######################################
+static inline unsigned int lowestBit(const card64 value)
+{
+   return(__builtin_ctzll((unsigned long long)value));
+}
+
+
+// ###### Find free slot ####################################################
+int ExtSocketDescriptorMaster::findFreeSocket()
+{
+   // Take the lowest page having free slots, so that IDs >= FD_SETSIZE are
+   // only used when the first page is full. Within a page, take the
+   // highest free ID, like the former static table.
+   for(unsigned int i = 0;i < MaxPages / WordBits;i++) {
+      if(FreePageMap[i] != 0) {
+         const unsigned int page = (i * WordBits) + lowestBit(FreePageMap[i]);
+         for(int j = (int)(PageSize / WordBits) - 1;j >= 0;j--) {
+            if(FreeMap[page][j] != 0) {
+               return((int)((page * PageSize) + (j * WordBits) + highestBit(FreeMap[page][j])));
+            }
+         }
+      }
+   }
+   return(-1);
+}
+
+
+// ###### Allocate new page of the descriptor table #########################
+ExtSocketDescriptor* ExtSocketDescriptorMaster::allocatePage()
+{
+   if(PageCount >= MaxPages) {
+      return(NULL);
+   }
+   ExtSocketDescriptor* page = new ExtSocketDescriptor[PageSize];
+   for(unsigned int i = 0;i < PageSize;i++) {
+      page[i].Type = ExtSocketDescriptor::ESDT_Invalid;
+   }
+   // getSocket() and getSocketLimit() read Pages[] and PageCount without
+   // the table lock. Therefore, the initialized page is published by
+   // release stores, which pair with the acquire loads there.
+   __atomic_store_n(&Pages[PageCount], page, __ATOMIC_RELEASE);
+
+   // Within the first page, IDs are limited by getdtablesize(), like for
+   // the select()-compatible range of the former static table.
+   const unsigned int limit = (PageCount > 0) ?
+                                 PageSize : std::min(PageSize, (unsigned int)getdtablesize());
+   for(unsigned int i = 0;i < limit;i++) {
+      markFree((PageCount * PageSize) + i);
+   }
+   __atomic_store_n(&PageCount, PageCount + 1, __ATOMIC_RELEASE);
+   return(page);
 }
 
 
 // ###### Get ExtSocketDescriptor for given ID ##############################
 inline ExtSocketDescriptor* ExtSocketDescriptorMaster::getSocket(const int id)
 {
-   if((id < (int)MaxSockets) && (id >= 0)) {
-      return(&Sockets[id]);
+   if(id >= 0) {
+      const unsigned int page = (unsigned int)id / PageSize;
+      if(page < MaxPages) {
+         ExtSocketDescriptor* descriptors = __atomic_load_n(&Pages[page], __ATOMIC_ACQUIRE);
+         if(descriptors != NULL) {
+            return(&descriptors[(unsigned int)id % PageSize]);
+         }
+      }
    }
    return(NULL);
 }
 
 
+// ###### Get upper limit of currently available IDs ########################
+inline unsigned int ExtSocketDescriptorMaster::getSocketLimit()
+{
+   return(__atomic_load_n(&PageCount, __ATOMIC_ACQUIRE) * PageSize);
+}
+
+
 // ###### Set ExtSocketDescriptor of given ID ###############################
 int ExtSocketDescriptorMaster::setSocket(const ExtSocketDescriptor& newSocket)
 {
-   // This operation must be atomic!
-   SCTPSocketMaster::MasterInstance.lock();
-   for(int i = (int)(std::min((int)FD_SETSIZE, getdtablesize())) - 1;i >= 0;i--) {
-      if(Sockets[i].Type == ExtSocketDescriptor::ESDT_Invalid) {
-         Sockets[i] = newSocket;
-         SCTPSocketMaster::MasterInstance.unlock();
-         return(i);
+   // This operation must be atomic! The SCTPSocketMaster lock is not
+   // necessary here, since slots are only reused after releaseSocket().
+   TableLock.synchronized();
+   int id = findFreeSocket();
+   if(id < 0) {
+      // ====== Table is full -> grow =======================================
+      if(allocatePage() != NULL) {
+         id = findFreeSocket();
       }
    }
-   SCTPSocketMaster::MasterInstance.unlock();
-   return(-EMFILE);
+   if(id >= 0) {
+      markUsed((unsigned int)id);
+      *getSocket(id) = newSocket;
+   }
+   TableLock.unsynchronized();
+   return((id >= 0) ? id : -EMFILE);
+}
+
+
+// ###### Release ExtSocketDescriptor of given ID ###########################
+void ExtSocketDescriptorMaster::releaseSocket(const int id)
+{
+   ExtSocketDescriptor* tdSocket = getSocket(id);
+   if(tdSocket != NULL) {
+      TableLock.synchronized();
+      if(tdSocket->Type != ExtSocketDescriptor::ESDT_Invalid) {
+         tdSocket->Type = ExtSocketDescriptor::ESDT_Invalid;
+         markFree((unsigned int)id);
+      }
+      TableLock.unsynchronized();
+   }
 }
 
 
@@ -438,6 +566,7 @@ int ext_socket(int domain, int type, int protocol)
             SCTP_RECVDATAIOEVNT );
       }
 
+      tdSocket.Socket.SCTPSocketDesc.SCTPSocketPtr->addDescriptorReference();
       int result = ExtSocketDescriptorMaster::setSocket(tdSocket);
       if(result < 0) {
          delete tdSocket.Socket.SCTPSocketDesc.SCTPSocketPtr;
@@ -523,24 +652,6 @@ int ext_pipe(int fds[2])
 }
 
 
-// ###### Check whether the SCTP socket is still referenced #######
-static bool mayRemoveSocket(ExtSocketDescriptor* tdSocket)
-{
-   const SCTPSocket* sctpSocket = tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr;
-
-   for(unsigned int i = 1;i <= ExtSocketDescriptorMaster::MaxSockets;i++) {
-      ExtSocketDescriptor* td = ExtSocketDescriptorMaster::getSocket(i);
-      if((td != NULL) &&
-         (td != tdSocket) &&
-         (td->Type == ExtSocketDescriptor::ESDT_SCTP) &&
-         (td->Socket.SCTPSocketDesc.SCTPSocketPtr == sctpSocket)) {
-         return(false);
-      }
-   }
-   return(true);
-}
-
-
 // ###### close() wrapper ###################################################
 int ext_close(int sockfd)
 {
@@ -548,6 +659,10 @@ int ext_close(int sockfd)
    if(tdSocket != NULL) {
       SCTPSocketMaster::MasterInstance.lock();
 
+      if(tdSocket->Type != ExtSocketDescriptor::ESDT_Epoll) {
+         ExtEpoll::removeDescriptor(sockfd);
+      }
+
       switch(tdSocket->Type) {
          case ExtSocketDescriptor::ESDT_SCTP:
             if(tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr != NULL) {
@@ -563,7 +678,7 @@ int ext_close(int sockfd)
                tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr = NULL;
             }
             if(tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr != NULL) {
-               if(mayRemoveSocket(tdSocket)) {
+               if(tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->removeDescriptorReference()) {
                   if(tdSocket->Socket.SCTPSocketDesc.Linger.l_onoff == 1) {
                      if(tdSocket->Socket.SCTPSocketDesc.Linger.l_linger > 0) {
                         tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->unbind(false);
@@ -586,6 +701,11 @@ int ext_close(int sockfd)
             close(tdSocket->Socket.SystemSocketID);
             tdSocket->Socket.SystemSocketID = 0;
           break;
+         case ExtSocketDescriptor::ESDT_Epoll:
+            // Deleted when the last ext_epoll_wait() call has returned.
+            ExtEpoll::close(tdSocket->Socket.EpollPtr);
+            tdSocket->Socket.EpollPtr = NULL;
+          break;
          default:
             SCTPSocketMaster::MasterInstance.unlock();
             errno_return(-ENXIO);
@@ -593,7 +713,7 @@ int ext_close(int sockfd)
       }
 
       // Finally, invalidate socket descriptor
-      tdSocket->Type = ExtSocketDescriptor::ESDT_Invalid;
+      ExtSocketDescriptorMaster::releaseSocket(sockfd);
 
       SCTPSocketMaster::MasterInstance.unlock();
       errno_return(0);
@@ -837,9 +957,11 @@ int ext_accept(int sockfd, struct sockaddr* addr, socklen_t* addrlen)
                      newExtSocketDescriptor.Socket.SCTPSocketDesc.ConnectionOriented = true;
                      newExtSocketDescriptor.Socket.SCTPSocketDesc.SCTPSocketPtr      = tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr;
                      newExtSocketDescriptor.Socket.SCTPSocketDesc.SCTPAssociationPtr = association;
+                     newExtSocketDescriptor.Socket.SCTPSocketDesc.SCTPSocketPtr->addDescriptorReference();
                      const int newFD = ExtSocketDescriptorMaster::setSocket(newExtSocketDescriptor);
                      SocketAddress::deleteAddressList(remoteAddressArray);
                      if(newFD < 0) {
+                        newExtSocketDescriptor.Socket.SCTPSocketDesc.SCTPSocketPtr->removeDescriptorReference();
                         delete newExtSocketDescriptor.Socket.SCTPSocketDesc.SCTPAssociationPtr;
                         newExtSocketDescriptor.Socket.SCTPSocketDesc.SCTPAssociationPtr = NULL;
                      }
@@ -1327,6 +1449,18 @@ int ext_getsockopt(int sockfd, int level, int optname, void* optval, socklen_t*
                             }
                             errno_return(-EBADF);
                           break;
+                         case SCTP_EAGER_RECEIVE:
+                            if((optval == NULL) || ((size_t)*optlen < sizeof(unsigned int))) {
+                               errno_return(-EINVAL);
+                            }
+                            if(tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr != NULL) {
+                               *((unsigned int*)optval) =
+                                  (unsigned int)tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->getEagerReceive();
+                               *optlen = sizeof(unsigned int);
+                               errno_return(0);
+                            }
+                            errno_return(-EBADF);
+                          break;
                          default:
                             errno_return(-EOPNOTSUPP);
                           break;
@@ -1783,6 +1917,17 @@ int ext_setsockopt(int sockfd, int level, int optname, const void* optval, sockl
                                (card64)1000000 * (card64)*((unsigned int*)optval));
                             errno_return(0);
                           break;
+                         case SCTP_EAGER_RECEIVE:
+                            if((optval == NULL) || ((size_t)optlen < sizeof(unsigned int))) {
+                               errno_return(-EINVAL);
+                            }
+                            if(tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr == NULL) {
+                               errno_return(-EBADF);
+                            }
+                            tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->setEagerReceive(
+                               *((unsigned int*)optval));
+                            errno_return(0);
+                          break;
                        }
                      break;
 
@@ -1944,6 +2089,7 @@ int ext_connectx(int                    sockfd,
                         delete addressArray[i];
                         addressArray[i] = NULL;
                      }
+                     ExtEpoll::updateDescriptor(sockfd);
                      if(tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr == NULL) {
                         errno_return(-EIO);
                      }
@@ -2051,138 +2197,117 @@ ssize_t ext_recvfrom(int sockfd, void* buf, size_t len, int flags,
 }
 
 
-// ###### recvmsg() wrapper #################################################
-static int ext_recvmsg_singlebuffer(int sockfd, struct msghdr* msg, int flags,
-                                    const int receiveNotifications)
+// ###### Receive message from resolved descriptor #########################
+// Returns the number of bytes received or a negative error code.
+static int receiveMessage(ExtSocketDescriptor* tdSocket, struct msghdr* msg, int flags,
+                          const int receiveNotifications)
 {
-   ExtSocketDescriptor* tdSocket = ExtSocketDescriptorMaster::getSocket(sockfd);
-   if(tdSocket != NULL) {
-      unsigned int   assocID           = 0;
-      unsigned short streamID          = 0;
-      unsigned int   protoID           = 0;
-      uint16_t       ssn               = 0;
-      uint32_t       tsn               = 0;
-      unsigned int   notificationFlags = 0;
-      SocketAddress* remoteAddress     = NULL;
-      int result = -EOPNOTSUPP;
-      switch(tdSocket->Type) {
-         case ExtSocketDescriptor::ESDT_SCTP:
-               if((msg == NULL) || (msg->msg_iov == NULL)) {
-                  errno_return(-EINVAL);
-               }
-               msg->msg_flags |= flags;
+   unsigned int   assocID           = 0;
+   unsigned short streamID          = 0;
+   unsigned int   protoID           = 0;
+   uint16_t       ssn               = 0;
+   uint32_t       tsn               = 0;
+   unsigned int   notificationFlags = 0;
+   size_t         received          = 0;
+   socklen_t      nameLength        = 0;
+   int result = -EOPNOTSUPP;
+   switch(tdSocket->Type) {
+      case ExtSocketDescriptor::ESDT_SCTP:
+            if((msg == NULL) || (msg->msg_iov == NULL)) {
+               return(-EINVAL);
+            }
+            msg->msg_flags = (msg->msg_flags & ~(MSG_EOR|MSG_TRUNC)) | flags;
 #ifndef NON_RECVMSG_NOTIFICATIONS
-               if(receiveNotifications) {
-                  msg->msg_flags |= MSG_NOTIFICATION;
-               }
-               else {
-                  msg->msg_flags &= ~MSG_NOTIFICATION;
-               }
-#else
+            if(receiveNotifications) {
                msg->msg_flags |= MSG_NOTIFICATION;
+            }
+            else {
+               msg->msg_flags &= ~MSG_NOTIFICATION;
+            }
+#else
+            msg->msg_flags |= MSG_NOTIFICATION;
 #endif
-               if(tdSocket->Socket.SCTPSocketDesc.Flags & O_NONBLOCK) {
-                  msg->msg_flags |= MSG_DONTWAIT;
-               }
-               if((tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr != NULL) && (tdSocket->Socket.SCTPSocketDesc.ConnectionOriented)) {
-                  const size_t oldSize = msg->msg_iov->iov_len;
-                  do {
-                     msg->msg_iov->iov_len = oldSize;
-                     result = tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr->receive(
-                                 (char*)msg->msg_iov->iov_base,
-                                 msg->msg_iov->iov_len,
-                                 msg->msg_flags,
-                                 streamID, protoID,
-                                 ssn, tsn);
-                  } while((result == -EAGAIN) && !(msg->msg_flags & MSG_DONTWAIT));
-                  notificationFlags = tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr->getNotificationFlags();
-                  assocID = tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr->getID();
-               }
-               else if(tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr != NULL) {
-                  const size_t oldSize = msg->msg_iov->iov_len;
-                  do {
-                     if(remoteAddress != NULL) {
-                        delete remoteAddress;
-                        remoteAddress = NULL;
-                     }
-                     msg->msg_iov->iov_len = oldSize;
-                     result = tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->receiveFrom(
-                                 (char*)msg->msg_iov->iov_base,
-                                 msg->msg_iov->iov_len,
-                                 msg->msg_flags,
-                                 assocID, streamID, protoID,
-                                 ssn, tsn,
-                                 &remoteAddress);
-                  } while((result == -EAGAIN) && !(msg->msg_flags & MSG_DONTWAIT));
-                  notificationFlags = tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->getNotificationFlags();
-               }
-               else {
-                  result = -EBADF;
-               }
-
-               // ====== Set result to length in case of success ============
-               if(result >= 0) {
-                  result = msg->msg_iov->iov_len;
-               }
-           break;
-         case ExtSocketDescriptor::ESDT_System: {
-               const int result = recvmsg(tdSocket->Socket.SystemSocketID,msg,flags);
-               return(result);
+            if(tdSocket->Socket.SCTPSocketDesc.Flags & O_NONBLOCK) {
+               msg->msg_flags |= MSG_DONTWAIT;
+            }
+            if((tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr != NULL) && (tdSocket->Socket.SCTPSocketDesc.ConnectionOriented)) {
+               do {
+                  result = tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr->receive(
+                              msg->msg_iov, msg->msg_iovlen,
+                              received,
+                              msg->msg_flags,
+                              streamID, protoID,
+                              ssn, tsn);
+               } while((result == -EAGAIN) && !(msg->msg_flags & MSG_DONTWAIT));
+               notificationFlags = tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr->getNotificationFlags();
+               assocID = tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr->getID();
+            }
+            else if(tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr != NULL) {
+               do {
+                  // The remote address is copied directly into msg_name.
+                  nameLength = (msg->msg_name != NULL) ? msg->msg_namelen : 0;
+                  result = tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->receiveFrom(
+                              msg->msg_iov, msg->msg_iovlen,
+                              received,
+                              msg->msg_flags,
+                              assocID, streamID, protoID,
+                              ssn, tsn,
+                              (sockaddr*)msg->msg_name, &nameLength);
+               } while((result == -EAGAIN) && !(msg->msg_flags & MSG_DONTWAIT));
+               notificationFlags = tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->getNotificationFlags();
+            }
+            else {
+               result = -EBADF;
             }
-           break;
-         default:
-            errno_return(-ENXIO);
-          break;
-      }
 
-      if(result >= 0) {
-         if((msg->msg_name != NULL) &&
-            (remoteAddress != NULL)) {
-            msg->msg_namelen = remoteAddress->getSystemAddress(
-                                  (sockaddr*)msg->msg_name,
-                                  (socklen_t)msg->msg_namelen,
-                                  tdSocket->Socket.SCTPSocketDesc.Domain);
-         }
-         else {
-            msg->msg_namelen = 0;
-         }
-         if((notificationFlags & SCTP_RECVDATAIOEVNT) &&
-            (msg->msg_control != NULL) &&
-            (msg->msg_controllen >= (socklen_t)CSpace(sizeof(sctp_sndrcvinfo)))) {
-            cmsghdr* cmsg = (cmsghdr*)msg->msg_control;
-            cmsg->cmsg_len   = CSpace(sizeof(sctp_sndrcvinfo));
-            cmsg->cmsg_level = IPPROTO_SCTP;
-            cmsg->cmsg_type  = SCTP_SNDRCV;
-            sctp_sndrcvinfo* info = (sctp_sndrcvinfo*)((long)cmsg + (long)sizeof(cmsghdr));
-            info->sinfo_stream     = streamID;
-            info->sinfo_ssn        = ssn;
-            info->sinfo_tsn        = tsn;
-            info->sinfo_flags      = flags;
-            info->sinfo_ppid       = protoID;
-            info->sinfo_timetolive = 0;
-            info->sinfo_context    = 0;
-            info->sinfo_cumtsn     = 0;
-            info->sinfo_assoc_id   = assocID;
-            msg->msg_controllen = CSpace(sizeof(sctp_sndrcvinfo));
-         }
-         else {
-            msg->msg_control    = NULL;
-            msg->msg_controllen = 0;
+            // ====== Set result to length in case of success ============
+            if(result >= 0) {
+               result = (int)received;
+            }
+        break;
+      case ExtSocketDescriptor::ESDT_System: {
+            const int result = recvmsg(tdSocket->Socket.SystemSocketID,msg,flags);
+            return((result < 0) ? -errno : result);
          }
+        break;
+      default:
+         return(-ENXIO);
+       break;
+   }
+
+   if(result >= 0) {
+      msg->msg_namelen = nameLength;
+      if((notificationFlags & SCTP_RECVDATAIOEVNT) &&
+         (msg->msg_control != NULL) &&
+         (msg->msg_controllen >= (socklen_t)CSpace(sizeof(sctp_sndrcvinfo)))) {
+         cmsghdr* cmsg = (cmsghdr*)msg->msg_control;
+         cmsg->cmsg_len   = CSpace(sizeof(sctp_sndrcvinfo));
+         cmsg->cmsg_level = IPPROTO_SCTP;
+         cmsg->cmsg_type  = SCTP_SNDRCV;
+         sctp_sndrcvinfo* info = (sctp_sndrcvinfo*)((long)cmsg + (long)sizeof(cmsghdr));
+         info->sinfo_stream     = streamID;
+         info->sinfo_ssn        = ssn;
+         info->sinfo_tsn        = tsn;
+         info->sinfo_flags      = flags;
+         info->sinfo_ppid       = protoID;
+         info->sinfo_timetolive = 0;
+         info->sinfo_context    = 0;
+         info->sinfo_cumtsn     = 0;
+         info->sinfo_assoc_id   = assocID;
+         msg->msg_controllen = CSpace(sizeof(sctp_sndrcvinfo));
       }
       else {
-         msg->msg_namelen    = 0;
-         msg->msg_name       = NULL;
-         msg->msg_controllen = 0;
          msg->msg_control    = NULL;
+         msg->msg_controllen = 0;
       }
-
-      if(remoteAddress != NULL) {
-         delete remoteAddress;
-      }
-      errno_return(result);
    }
-   errno_return(-EBADF);
+   else {
+      msg->msg_namelen    = 0;
+      msg->msg_name       = NULL;
+      msg->msg_controllen = 0;
+      msg->msg_control    = NULL;
+   }
+   return(result);
 }
 
 
@@ -2190,27 +2315,11 @@ static int ext_recvmsg_singlebuffer(int sockfd, struct msghdr* msg, int flags,
 int ext_recvmsg2(int sockfd, struct msghdr* msg, int flags,
                  const int receiveNotifications)
 {
-   struct iovec* iov   = msg->msg_iov;
-   const size_t  count = msg->msg_iovlen;
-   int result = 0;
-   for(unsigned int i = 0;i < count;i++) {
-      msg->msg_iov    = (iovec*)((long)iov + ((long)i * (long)sizeof(iovec)));
-      msg->msg_iovlen = 1;
-      const int subresult = ext_recvmsg_singlebuffer(sockfd,msg,flags,receiveNotifications);
-      if(subresult > 0) {
-         result += subresult;
-      }
-      if((result == 0) && (subresult <= 0)) {
-         result = subresult;
-         break;
-      }
-      if((subresult < (int)msg->msg_iov->iov_len) && (msg->msg_flags & MSG_EOR)) {
-         break;
-      }
+   ExtSocketDescriptor* tdSocket = ExtSocketDescriptorMaster::getSocket(sockfd);
+   if(tdSocket != NULL) {
+      errno_return(receiveMessage(tdSocket,msg,flags,receiveNotifications));
    }
-   msg->msg_iov    = iov;
-   msg->msg_iovlen = count;
-   return(result);
+   errno_return(-EBADF);
 }
 
 
@@ -2221,6 +2330,53 @@ ssize_t ext_recvmsg(int sockfd, struct msghdr* msg, int flags)
 }
 
 
+// ###### recvmmsg() implementation #########################################
+int ext_recvmmsg(int sockfd, struct ext_mmsghdr* msgvec, unsigned int vlen, int flags)
+{
+   ExtSocketDescriptor* tdSocket = ExtSocketDescriptorMaster::getSocket(sockfd);
+   if(tdSocket == NULL) {
+      errno_return(-EBADF);
+   }
+   if((msgvec == NULL) || (vlen == 0)) {
+      errno_return(-EINVAL);
+   }
+
+   // ====== Receive first message (may block) ==============================
+   // The descriptor is resolved once; all messages use receiveMessage().
+   msgvec[0].msg_hdr.msg_flags = 0;
+   int result = receiveMessage(tdSocket,&msgvec[0].msg_hdr,flags,1);
+   if(result < 0) {
+      errno_return(result);
+   }
+   msgvec[0].msg_len = (unsigned int)result;
+   unsigned int received = 1;
+
+   // ====== Receive further messages, as long as available =================
+   // The SCTPSocketMaster lock is obtained once for the whole batch, so
+   // that the sctplib receive calls do not have to obtain it for each
+   // message. It is not needed for sockets in eager receive mode.
+   const bool masterLock = (tdSocket->Type == ExtSocketDescriptor::ESDT_SCTP) &&
+                           (SCTPSocketMaster::MasterInstance.running()) &&
+                           ((tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr == NULL) ||
+                            (tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->getEagerReceive() == 0));
+   if(masterLock) {
+      SCTPSocketMaster::MasterInstance.lock();
+   }
+   while((result > 0) && (received < vlen)) {
+      msgvec[received].msg_hdr.msg_flags = 0;
+      result = receiveMessage(tdSocket,&msgvec[received].msg_hdr,flags|MSG_DONTWAIT,1);
+      if(result > 0) {
+         msgvec[received].msg_len = (unsigned int)result;
+         received++;
+      }
+   }
+   if(masterLock) {
+      SCTPSocketMaster::MasterInstance.unlock();
+   }
+   return((int)received);
+}
+
+
 // ###### send() wrapper ####################################################
 ssize_t ext_send(int sockfd, const void* msg, size_t len, int flags)
 {
@@ -2272,198 +2428,300 @@ ssize_t ext_sendto(int sockfd, const void* buf, size_t len, int flags,
 }
 
 
-// ###### sendmsg() wrapper #################################################
-static int ext_sendmsg_singlebuffer(int sockfd, const struct msghdr* msg, int flags)
+// ###### Destination cache for ext_sendmmsg() ############################
+// The messages of a batch usually have the same destination. Then, the
+// destination's SocketAddress is only created once for the whole batch.
+struct SendDestination {
+   SocketAddress*   Address;
+   sockaddr_storage Name;
+   socklen_t        NameLength;
+};
+
+
+// ###### Get cached destination address of message ########################
+static const SocketAddress* getSendDestination(SendDestination* destination,
+                                               const struct msghdr* msg)
 {
-   ExtSocketDescriptor* tdSocket = ExtSocketDescriptorMaster::getSocket(sockfd);
-   if(tdSocket != NULL) {
-      switch(tdSocket->Type) {
-         case ExtSocketDescriptor::ESDT_SCTP:
-            {
-               if(msg == NULL) {
-                  return(-EINVAL);
-               }
-               bindToAny(tdSocket);
-               bool             useDefaults = true;
-               sctp_sndrcvinfo* info        = NULL;
-               for(const cmsghdr* cmsg = CFirstHeader(msg);
-                  cmsg != NULL;
-                  cmsg = CNextHeader(msg,cmsg)) {
-                  if(cmsg->cmsg_level == IPPROTO_SCTP) {
-                     if(cmsg->cmsg_type == SCTP_SNDRCV) {
-                        if(cmsg->cmsg_len >= (socklen_t)sizeof(sctp_sndrcvinfo)) {
-                           info        = (sctp_sndrcvinfo*)CData(cmsg);
-                           useDefaults = false;
-                        }
-                        else {
-                           errno_return(-EINVAL);
-                        }
+   if((destination->Address != NULL) &&
+      (destination->NameLength == msg->msg_namelen) &&
+      (memcmp(&destination->Name, msg->msg_name, msg->msg_namelen) == 0)) {
+      return(destination->Address);
+   }
+
+   delete destination->Address;
+   destination->Address = NULL;
+   if(msg->msg_namelen <= (socklen_t)sizeof(destination->Name)) {
+      destination->Address = SocketAddress::createSocketAddress(
+                                0, (sockaddr*)msg->msg_name, msg->msg_namelen);
+      if(destination->Address != NULL) {
+         memcpy(&destination->Name, msg->msg_name, msg->msg_namelen);
+         destination->NameLength = msg->msg_namelen;
+      }
+   }
+   return(destination->Address);
+}
+
+
+// ###### Send single-buffer message to resolved descriptor ################
+// Returns the number of bytes sent or a negative error code.
+static int sendSingleBuffer(ExtSocketDescriptor* tdSocket, int sockfd,
+                            const struct msghdr* msg, int flags,
+                            SendDestination* destination)
+{
+   switch(tdSocket->Type) {
+      case ExtSocketDescriptor::ESDT_SCTP:
+         {
+            if(msg == NULL) {
+               return(-EINVAL);
+            }
+            bindToAny(tdSocket);
+            bool             useDefaults = true;
+            sctp_sndrcvinfo* info        = NULL;
+            for(const cmsghdr* cmsg = CFirstHeader(msg);
+               cmsg != NULL;
+               cmsg = CNextHeader(msg,cmsg)) {
+               if(cmsg->cmsg_level == IPPROTO_SCTP) {
+                  if(cmsg->cmsg_type == SCTP_SNDRCV) {
+                     if(cmsg->cmsg_len >= (socklen_t)sizeof(sctp_sndrcvinfo)) {
+                        info        = (sctp_sndrcvinfo*)CData(cmsg);
+                        useDefaults = false;
                      }
-                     else if(cmsg->cmsg_type == SCTP_INIT) {
-                        const sctp_initmsg* initmsg = (sctp_initmsg*)CData(cmsg);
-                        tdSocket->Socket.SCTPSocketDesc.InitMsg = *initmsg;
-                        if((tdSocket->Socket.SCTPSocketDesc.ConnectionOriented) && (msg->msg_name != NULL)) {
-                           if(tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr != NULL) {
-                              errno_return(-EBUSY);
-                           }
-                           const SocketAddress* addressArray[2];
-                           addressArray[0] = SocketAddress::createSocketAddress(
-                                                0, (sockaddr*)msg->msg_name, msg->msg_namelen);
-                           addressArray[1] = NULL;
-                           if(addressArray[0] != NULL) {
-                              tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr =
-                                 tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->associate(
-                                    initmsg->sinit_num_ostreams,
-                                    initmsg->sinit_max_attempts,
-                                    initmsg->sinit_max_init_timeo,
-                                    (const SocketAddress**)&addressArray,
-                                    !(tdSocket->Socket.SCTPSocketDesc.Flags & O_NONBLOCK));
-                              delete addressArray[0];
-                              addressArray[0] = NULL;
-                              if(tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr == NULL) {
-                                 errno_return(-ENOTCONN);
-                              }
-                           }
-                           else {
-                              errno_return(-EADDRNOTAVAIL);
+                     else {
+                        return(-EINVAL);
+                     }
+                  }
+                  else if(cmsg->cmsg_type == SCTP_INIT) {
+                     const sctp_initmsg* initmsg = (sctp_initmsg*)CData(cmsg);
+                     tdSocket->Socket.SCTPSocketDesc.InitMsg = *initmsg;
+                     if((tdSocket->Socket.SCTPSocketDesc.ConnectionOriented) && (msg->msg_name != NULL)) {
+                        if(tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr != NULL) {
+                           return(-EBUSY);
+                        }
+                        const SocketAddress* addressArray[2];
+                        addressArray[0] = SocketAddress::createSocketAddress(
+                                             0, (sockaddr*)msg->msg_name, msg->msg_namelen);
+                        addressArray[1] = NULL;
+                        if(addressArray[0] != NULL) {
+                           tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr =
+                              tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->associate(
+                                 initmsg->sinit_num_ostreams,
+                                 initmsg->sinit_max_attempts,
+                                 initmsg->sinit_max_init_timeo,
+                                 (const SocketAddress**)&addressArray,
+                                 !(tdSocket->Socket.SCTPSocketDesc.Flags & O_NONBLOCK));
+                           delete addressArray[0];
+                           addressArray[0] = NULL;
+                           if(tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr == NULL) {
+                              return(-ENOTCONN);
                            }
+                           ExtEpoll::updateDescriptor(sockfd);
+                        }
+                        else {
+                           return(-EADDRNOTAVAIL);
                         }
                      }
                   }
                }
+            }
 
-               flags |= msg->msg_flags;
-               if(info != NULL) {
-                  flags |= info->sinfo_flags;
-               }
-               if(tdSocket->Socket.SCTPSocketDesc.Flags & O_NONBLOCK) {
-                  flags |= MSG_DONTWAIT;
-               }
-               if(msg->msg_name != NULL) {
-                  int result = -EBADF;
-                  const SocketAddress* destinationAddressList[SCTP_MAX_NUM_ADDRESSES + 1];
-                  if(tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr != NULL) {
-                     if(!(flags & MSG_MULTIADDRS)) {
-                        destinationAddressList[0] = SocketAddress::createSocketAddress(
-                                                       0, (sockaddr*)msg->msg_name, msg->msg_namelen);
-                        destinationAddressList[1] = NULL;
-                     }
-                     else {
-                        sockaddr* sa = (sockaddr*)msg->msg_name;
-                        size_t    i;
-                        for(i = 0;i < (size_t)msg->msg_namelen;i++) {
-                           destinationAddressList[i] = SocketAddress::createSocketAddress(
-                                                          0, sa, sizeof(sockaddr_storage));
-                           if(destinationAddressList[i] == NULL) {
-                              errno_return(-EINVAL);
-                           }
-                           // std::cout << "#" << i << ": " << *(destinationAddressList[i]) << std::endl;
-                           switch(sa->sa_family) {
-                              case AF_INET:
-                                 sa = (sockaddr*)((long)sa + sizeof(sockaddr_in));
-                               break;
-                              case AF_INET6:
-                                 sa = (sockaddr*)((long)sa + sizeof(sockaddr_in6));
-                               break;
-                              default:
-                                 errno_return(-EINVAL);
-                               break;
-                           }
-                        }
-                        destinationAddressList[i++] = NULL;
+            flags |= msg->msg_flags;
+            if(info != NULL) {
+               flags |= info->sinfo_flags;
+            }
+            if(tdSocket->Socket.SCTPSocketDesc.Flags & O_NONBLOCK) {
+               flags |= MSG_DONTWAIT;
+            }
+            if(msg->msg_name != NULL) {
+               int result = -EBADF;
+               const SocketAddress* destinationAddressList[SCTP_MAX_NUM_ADDRESSES + 1];
+               const SocketAddress* cachedDestination = NULL;
+               if(tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr != NULL) {
+                  if(!(flags & MSG_MULTIADDRS)) {
+                     if(destination != NULL) {
+                        cachedDestination = getSendDestination(destination,msg);
                      }
-                     unsigned int idZero = 0;
-                     result = tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->sendTo(
-                                 (char*)msg->msg_iov->iov_base,
-                                 msg->msg_iov->iov_len,
-                                 flags,
-                                 (info != NULL) ? info->sinfo_assoc_id : idZero,
-                                 (info != NULL) ? info->sinfo_stream   : 0x0000,
-                                 (info != NULL) ? info->sinfo_ppid     : 0x00000000,
-                                 ((info != NULL) && (info->sinfo_flags & MSG_PR_SCTP_TTL)) ? info->sinfo_timetolive : SCTP_INFINITE_LIFETIME,
-                                 tdSocket->Socket.SCTPSocketDesc.InitMsg.sinit_max_attempts,
-                                 tdSocket->Socket.SCTPSocketDesc.InitMsg.sinit_max_init_timeo,
-                                 useDefaults,
-                                 (const SocketAddress**)&destinationAddressList,
-                                 tdSocket->Socket.SCTPSocketDesc.InitMsg.sinit_num_ostreams);
-                     for(size_t i = 0;i  < SCTP_MAX_NUM_ADDRESSES;i++) {
-                        if(destinationAddressList[i] != NULL) {
-                           delete destinationAddressList[i];
-                           destinationAddressList[i] = NULL;
+                     destinationAddressList[0] = (cachedDestination != NULL) ?
+                        cachedDestination :
+                        SocketAddress::createSocketAddress(
+                           0, (sockaddr*)msg->msg_name, msg->msg_namelen);
+                     destinationAddressList[1] = NULL;
+                  }
+                  else {
+                     sockaddr* sa = (sockaddr*)msg->msg_name;
+                     size_t    i;
+                     for(i = 0;i < (size_t)msg->msg_namelen;i++) {
+                        destinationAddressList[i] = SocketAddress::createSocketAddress(
+                                                       0, sa, sizeof(sockaddr_storage));
+                        if(destinationAddressList[i] == NULL) {
+                           return(-EINVAL);
                         }
-                        else {
-                           break;
+                        // std::cout << "#" << i << ": " << *(destinationAddressList[i]) << std::endl;
+                        switch(sa->sa_family) {
+                           case AF_INET:
+                              sa = (sockaddr*)((long)sa + sizeof(sockaddr_in));
+                            break;
+                           case AF_INET6:
+                              sa = (sockaddr*)((long)sa + sizeof(sockaddr_in6));
+                            break;
+                           default:
+                              return(-EINVAL);
+                            break;
                         }
                      }
+                     destinationAddressList[i++] = NULL;
                   }
-                  errno_return(result);
-               }
-               else {
-                  if(tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr != NULL) {
-                     errno_return(tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr->send(
-                                  (char*)msg->msg_iov->iov_base,
-                                  msg->msg_iov->iov_len,
-                                  flags,
-                                  (info != NULL) ? info->sinfo_stream : 0x0000,
-                                  (info != NULL) ? info->sinfo_ppid   : 0x0000000,
-                                  ((info != NULL) && (info->sinfo_flags & MSG_PR_SCTP_TTL)) ? info->sinfo_timetolive : SCTP_INFINITE_LIFETIME,
-                                  useDefaults));
+                  unsigned int idZero = 0;
+                  result = tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->sendTo(
+                              (char*)msg->msg_iov->iov_base,
+                              msg->msg_iov->iov_len,
+                              flags,
+                              (info != NULL) ? info->sinfo_assoc_id : idZero,
+                              (info != NULL) ? info->sinfo_stream   : 0x0000,
+                              (info != NULL) ? info->sinfo_ppid     : 0x00000000,
+                              ((info != NULL) && (info->sinfo_flags & MSG_PR_SCTP_TTL)) ? info->sinfo_timetolive : SCTP_INFINITE_LIFETIME,
+                              tdSocket->Socket.SCTPSocketDesc.InitMsg.sinit_max_attempts,
+                              tdSocket->Socket.SCTPSocketDesc.InitMsg.sinit_max_init_timeo,
+                              useDefaults,
+                              (const SocketAddress**)&destinationAddressList,
+                              tdSocket->Socket.SCTPSocketDesc.InitMsg.sinit_num_ostreams);
+                  if(cachedDestination != NULL) {
+                     destinationAddressList[0] = NULL;   // Owned by destination cache
                   }
-                  else if(tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr != NULL) {
-                     unsigned int idZero = 0;
-                     errno_return(tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->sendTo(
-                                 (char*)msg->msg_iov->iov_base,
-                                 msg->msg_iov->iov_len,
-                                 flags,
-                                 (info != NULL) ? info->sinfo_assoc_id   : idZero,
-                                 (info != NULL) ? info->sinfo_stream     : 0x0000,
-                                 (info != NULL) ? info->sinfo_ppid       : 0x00000000,
-                                 ((info != NULL) && (info->sinfo_flags & MSG_PR_SCTP_TTL)) ? info->sinfo_timetolive : SCTP_INFINITE_LIFETIME,
-                                 tdSocket->Socket.SCTPSocketDesc.InitMsg.sinit_max_attempts,
-                                 tdSocket->Socket.SCTPSocketDesc.InitMsg.sinit_max_init_timeo,
-                                 useDefaults,
-                                 NULL,
-                                 tdSocket->Socket.SCTPSocketDesc.InitMsg.sinit_num_ostreams));
+                  for(size_t i = 0;i  < SCTP_MAX_NUM_ADDRESSES;i++) {
+                     if(destinationAddressList[i] != NULL) {
+                        delete destinationAddressList[i];
+                        destinationAddressList[i] = NULL;
+                     }
+                     else {
+                        break;
+                     }
                   }
-                  errno_return(-EBADF);
                }
-               errno_return(0);
+               return(result);
             }
-          break;
-         case ExtSocketDescriptor::ESDT_System:
-            return(sendmsg(tdSocket->Socket.SystemSocketID,msg,flags));
-          break;
-      }
-      errno_return(-ENXIO);
+            else {
+               if(tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr != NULL) {
+                  return(tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr->send(
+                               (char*)msg->msg_iov->iov_base,
+                               msg->msg_iov->iov_len,
+                               flags,
+                               (info != NULL) ? info->sinfo_stream : 0x0000,
+                               (info != NULL) ? info->sinfo_ppid   : 0x0000000,
+                               ((info != NULL) && (info->sinfo_flags & MSG_PR_SCTP_TTL)) ? info->sinfo_timetolive : SCTP_INFINITE_LIFETIME,
+                               useDefaults));
+               }
+               else if(tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr != NULL) {
+                  unsigned int idZero = 0;
+                  return(tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->sendTo(
+                              (char*)msg->msg_iov->iov_base,
+                              msg->msg_iov->iov_len,
+                              flags,
+                              (info != NULL) ? info->sinfo_assoc_id   : idZero,
+                              (info != NULL) ? info->sinfo_stream     : 0x0000,
+                              (info != NULL) ? info->sinfo_ppid       : 0x00000000,
+                              ((info != NULL) && (info->sinfo_flags & MSG_PR_SCTP_TTL)) ? info->sinfo_timetolive : SCTP_INFINITE_LIFETIME,
+                              tdSocket->Socket.SCTPSocketDesc.InitMsg.sinit_max_attempts,
+                              tdSocket->Socket.SCTPSocketDesc.InitMsg.sinit_max_init_timeo,
+                              useDefaults,
+                              NULL,
+                              tdSocket->Socket.SCTPSocketDesc.InitMsg.sinit_num_ostreams));
+               }
+               return(-EBADF);
+            }
+            return(0);
+         }
+       break;
+      case ExtSocketDescriptor::ESDT_System: {
+            const int result = sendmsg(tdSocket->Socket.SystemSocketID,msg,flags);
+            return((result < 0) ? -errno : result);
+         }
+       break;
    }
-   errno_return(-EBADF);
+   return(-ENXIO);
 }
 
 
-// ###### sendmsg() wrapper #################################################
-ssize_t ext_sendmsg(int sockfd, const struct msghdr* msg, int flags)
+// ###### Per-thread staging buffer for ext_sendmsg() ######################
+// sctplib's sctp_send() only accepts a single buffer. Therefore, messages
+// consisting of multiple iovecs are gathered into a per-thread staging
+// buffer, which is reused for subsequent messages. Buffers larger than
+// GatherBufferMaxRetained are only allocated for the current message.
+struct GatherBuffer {
+   char*  Buffer;
+   size_t Size;
+};
+
+static const size_t   GatherBufferMaxRetained = 65536;
+static pthread_key_t  GatherBufferKey;
+static pthread_once_t GatherBufferKeyOnce     = PTHREAD_ONCE_INIT;
+
+
+// ###### Free staging buffer at thread exit ################################
+static void freeGatherBuffer(void* data)
 {
-   struct iovec* iov    = msg->msg_iov;
-   const size_t  count  = msg->msg_iovlen;
+   GatherBuffer* gatherBuffer = (GatherBuffer*)data;
+   delete [] gatherBuffer->Buffer;
+   delete gatherBuffer;
+}
+
+
+// ###### Create staging buffer key #########################################
+static void createGatherBufferKey()
+{
+   pthread_key_create(&GatherBufferKey, freeGatherBuffer);
+}
 
-   if(count > 1) {
+
+// ###### Get staging buffer of calling thread ##############################
+static GatherBuffer* getGatherBuffer(const size_t required)
+{
+   pthread_once(&GatherBufferKeyOnce, createGatherBufferKey);
+   GatherBuffer* gatherBuffer = (GatherBuffer*)pthread_getspecific(GatherBufferKey);
+   if(gatherBuffer == NULL) {
+      gatherBuffer = new GatherBuffer;
+      gatherBuffer->Buffer = NULL;
+      gatherBuffer->Size   = 0;
+      pthread_setspecific(GatherBufferKey, gatherBuffer);
+   }
+   if(gatherBuffer->Size < required) {
+      delete [] gatherBuffer->Buffer;
+      gatherBuffer->Buffer = new char[required];
+      gatherBuffer->Size   = required;
+   }
+   return(gatherBuffer);
+}
+
+
+// ###### Send message to resolved descriptor ##############################
+// Returns the number of bytes sent or a negative error code.
+static int sendMessage(ExtSocketDescriptor* tdSocket, int sockfd,
+                       const struct msghdr* msg, int flags,
+                       SendDestination* destination)
+{
+   if(msg == NULL) {
+      return(-EINVAL);
+   }
+   const struct iovec* iov   = msg->msg_iov;
+   const size_t        count = msg->msg_iovlen;
+
+   if((count > 1) && (tdSocket->Type == ExtSocketDescriptor::ESDT_SCTP)) {
       size_t required = 0;
-      for(unsigned int i = 0;i < count;i++) {
-         const iovec* subvec = (iovec*)((long)iov + ((long)i * (long)sizeof(iovec)));
-         required += subvec->iov_len;
+      for(size_t i = 0;i < count;i++) {
+         required += iov[i].iov_len;
       }
 
-      char* buffer = new char[required];
-      if(buffer == NULL) {
-         return(-ENOMEM);
+      // ====== Gather iovecs into staging buffer ===========================
+      char* buffer;
+      if(required <= GatherBufferMaxRetained) {
+         buffer = getGatherBuffer(required)->Buffer;
       }
-      unsigned int j = 0;
-      for(unsigned int i = 0;i < count;i++) {
-         const iovec* subvec = (iovec*)((long)iov + ((long)i * (long)sizeof(iovec)));
-         const char*  base   = (char*)subvec->iov_base;
-         for(unsigned int k = 0;k < subvec->iov_len;k++) {
-            buffer[j++] = base[k];
-         }
+      else {
+         buffer = new char[required];
+      }
+      size_t position = 0;
+      for(size_t i = 0;i < count;i++) {
+         memcpy(&buffer[position], iov[i].iov_base, iov[i].iov_len);
+         position += iov[i].iov_len;
       }
 
       iovec newvec;
@@ -2478,14 +2736,145 @@ ssize_t ext_sendmsg(int sockfd, const struct msghdr* msg, int flags)
       newmsg.msg_iov        = &newvec;
       newmsg.msg_iovlen     = 1;
       newmsg.msg_flags      = msg->msg_flags;
-      const int result = ext_sendmsg_singlebuffer(sockfd,&newmsg,flags);
+      const int result = sendSingleBuffer(tdSocket,sockfd,&newmsg,flags,destination);
 
-      delete [] buffer;
+      if(required > GatherBufferMaxRetained) {
+         delete [] buffer;
+      }
       return(result);
    }
    else {
-      return(ext_sendmsg_singlebuffer(sockfd,msg,flags));
+      return(sendSingleBuffer(tdSocket,sockfd,msg,flags,destination));
+   }
+}
+
+
+// ###### sendmsg() wrapper #################################################
+ssize_t ext_sendmsg(int sockfd, const struct msghdr* msg, int flags)
+{
+   ExtSocketDescriptor* tdSocket = ExtSocketDescriptorMaster::getSocket(sockfd);
+   if(tdSocket != NULL) {
+      errno_return(sendMessage(tdSocket,sockfd,msg,flags,NULL));
+   }
+   errno_return(-EBADF);
+}
+
+
+// ###### Check, if message contains SCTP_INIT control data ################
+static bool hasInitControl(const struct msghdr* msg)
+{
+   for(const cmsghdr* cmsg = CFirstHeader(msg);
+       cmsg != NULL;
+       cmsg = CNextHeader(msg,cmsg)) {
+      if((cmsg->cmsg_level == IPPROTO_SCTP) && (cmsg->cmsg_type == SCTP_INIT)) {
+         return(true);
+      }
+   }
+   return(false);
+}
+
+
+// ###### Check, if message would establish a new association ##############
+static bool establishesAssociation(ExtSocketDescriptor*  tdSocket,
+                                   const struct msghdr*  msg,
+                                   const int             flags,
+                                   SendDestination*      destination)
+{
+   if((msg->msg_name == NULL) ||
+      (tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr == NULL)) {
+      return(false);
+   }
+   if((flags | msg->msg_flags) & MSG_MULTIADDRS) {
+      // Address lists are not checked here -> assume a new association.
+      return(true);
+   }
+   const SocketAddress* destinationAddressList[2];
+   destinationAddressList[0] = getSendDestination(destination, msg);
+   destinationAddressList[1] = NULL;
+   if(destinationAddressList[0] == NULL) {
+      return(true);
+   }
+   return(tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->wouldAutoConnect(
+             (const SocketAddress**)&destinationAddressList));
+}
+
+
+// ###### sendmmsg() implementation #########################################
+int ext_sendmmsg(int sockfd, struct ext_mmsghdr* msgvec, unsigned int vlen, int flags)
+{
+   ExtSocketDescriptor* tdSocket = ExtSocketDescriptorMaster::getSocket(sockfd);
+   if(tdSocket == NULL) {
+      errno_return(-EBADF);
+   }
+   if((msgvec == NULL) || (vlen == 0)) {
+      errno_return(-EINVAL);
+   }
+
+   // ====== Send messages ==================================================
+   // The SCTPSocketMaster lock is obtained once for the whole batch, so
+   // that association lookup and sctplib send calls do not have to obtain
+   // it for each message. Within the lock, nothing may wait for the master
+   // thread. Therefore, messages are sent with MSG_DONTWAIT. If the send
+   // queue is full and the caller wants to block, the lock is released
+   // to retry the message.
+   //
+   // Messages which may establish an association, i.e. messages with
+   // SCTP_INIT control data and messages to a destination without
+   // association on an auto-connect socket, are always sent without the
+   // lock and with the caller's flags. They behave exactly like
+   // ext_sendmsg() calls, including waiting for the establishment and
+   // reporting its failure. The batch stops at the first failed message;
+   // the number of messages sent before is returned, or the error if the
+   // first message fails.
+   //
+   // The descriptor is resolved once and the destination address is only
+   // recreated when it differs from the previous message's one.
+   const bool masterLock = (tdSocket->Type == ExtSocketDescriptor::ESDT_SCTP) &&
+                           (SCTPSocketMaster::MasterInstance.running());
+   SendDestination destination;
+   destination.Address    = NULL;
+   destination.NameLength = 0;
+   bool         locked = false;
+   unsigned int sent   = 0;
+   int          result = 0;
+   while(sent < vlen) {
+      const struct msghdr* msg      = &msgvec[sent].msg_hdr;
+      const bool           lockable = masterLock && (!hasInitControl(msg)) &&
+                                         (!establishesAssociation(tdSocket, msg, flags, &destination));
+      if((lockable) && (!locked)) {
+         SCTPSocketMaster::MasterInstance.lock();
+         locked = true;
+      }
+      else if((!lockable) && (locked)) {
+         SCTPSocketMaster::MasterInstance.unlock();
+         locked = false;
+      }
+
+      result = sendMessage(tdSocket,sockfd,msg,(locked) ? (flags|MSG_DONTWAIT) : flags,
+                           &destination);
+      if((locked) && (!(flags & MSG_DONTWAIT)) &&
+         ((result == -ENOBUFS) || (result == -EAGAIN))) {
+         // ====== Wait for free queue space without holding the lock =======
+         SCTPSocketMaster::MasterInstance.unlock();
+         locked = false;
+         result = sendMessage(tdSocket,sockfd,msg,flags,&destination);
+      }
+      if(result < 0) {
+         break;
+      }
+      msgvec[sent].msg_len = (unsigned int)result;
+      sent++;
+   }
+   if(locked) {
+      SCTPSocketMaster::MasterInstance.unlock();
+   }
+   delete destination.Address;
+
+   // ====== Return number of messages sent =================================
+   if(sent == 0) {
+      errno_return(result);
    }
+   return((int)sent);
 }
 
 
@@ -2521,23 +2910,76 @@ ssize_t ext_write(int fd, const void* buf, size_t count)
 }
 
 
-// Internal structure for ext_select().
+// Internal structure for ext_select(). It is kept per thread and reused
+// for subsequent calls, including the user socket notifications.
+// Each FD may have up to 3 conditions (read, write and except).
 struct SelectData
 {
-   cardinal   Conditions;
-   int        ConditionFD[FD_SETSIZE];
-   cardinal   ConditionType[FD_SETSIZE];
-   Condition* ConditionArray[FD_SETSIZE];
-   Condition* ParentConditionArray[FD_SETSIZE];
-   Condition  GlobalCondition;
-   Condition  ReadCondition;
-   Condition  WriteCondition;
-   Condition  ExceptCondition;
-   cardinal   UserCallbacks;
-   int        UserCallbackFD[FD_SETSIZE];
+   cardinal       Conditions;
+   int            ConditionFD[3 * FD_SETSIZE];
+   cardinal       ConditionType[3 * FD_SETSIZE];
+   LeanCondition* ConditionArray[3 * FD_SETSIZE];
+   Condition*     ParentConditionArray[3 * FD_SETSIZE];
+   Condition      GlobalCondition;
+   Condition      ReadCondition;
+   Condition      WriteCondition;
+   Condition      ExceptCondition;
+   cardinal       UserCallbacks;
+   cardinal       UserNotifications;
+   int            UserCallbackFD[FD_SETSIZE];
    SCTPSocketMaster::UserSocketNotification* UserNotification[FD_SETSIZE];
 };
 
+static pthread_key_t  SelectDataKey;
+static pthread_once_t SelectDataKeyOnce = PTHREAD_ONCE_INIT;
+
+
+// ###### Free SelectData structure at thread exit ##########################
+static void freeSelectData(void* data)
+{
+   SelectData* selectData = (SelectData*)data;
+   for(cardinal i = 0;i < selectData->UserNotifications;i++) {
+      delete selectData->UserNotification[i];
+   }
+   delete selectData;
+}
+
+
+// ###### Create SelectData key #############################################
+static void createSelectDataKey()
+{
+   pthread_key_create(&SelectDataKey, freeSelectData);
+}
+
+
+// ###### Get SelectData structure of calling thread ########################
+static SelectData* getSelectData()
+{
+   pthread_once(&SelectDataKeyOnce, createSelectDataKey);
+   SelectData* selectData = (SelectData*)pthread_getspecific(SelectDataKey);
+   if(selectData == NULL) {
+      selectData = new SelectData;
+      selectData->UserNotifications = 0;
+      selectData->GlobalCondition.setName("ext_select::GlobalCondition");
+      selectData->ReadCondition.setName("ext_select::ReadCondition");
+      selectData->WriteCondition.setName("ext_select::WriteCondition");
+      selectData->ExceptCondition.setName("ext_select::ExceptCondition");
+      selectData->ReadCondition.addParent(&selectData->GlobalCondition);
+      selectData->WriteCondition.addParent(&selectData->GlobalCondition);
+      selectData->ExceptCondition.addParent(&selectData->GlobalCondition);
+      pthread_setspecific(SelectDataKey, selectData);
+   }
+   selectData->Conditions    = 0;
+   selectData->UserCallbacks = 0;
+
+   // Reset fired state of the previous call.
+   selectData->ReadCondition.fired();
+   selectData->WriteCondition.fired();
+   selectData->ExceptCondition.fired();
+   selectData->GlobalCondition.fired();
+   return(selectData);
+}
+
 
 // ###### Add file descriptor to SelectData structure #######################
 static int collectSCTP_FDs(SelectData&                 selectData,
@@ -2614,8 +3056,11 @@ static int collectFDs(SelectData&     selectData,
                    << " (" << fd << ") with mask " << str << std::endl;
 #endif
          selectData.UserCallbackFD[selectData.UserCallbacks] = fd;
-         selectData.UserNotification[selectData.UserCallbacks] = new SCTPSocketMaster::UserSocketNotification;
+         if(selectData.UserCallbacks >= selectData.UserNotifications) {
+            selectData.UserNotification[selectData.UserNotifications++] = new SCTPSocketMaster::UserSocketNotification;
+         }
          if(selectData.UserNotification[selectData.UserCallbacks] != NULL) {
+            selectData.UserNotification[selectData.UserCallbacks]->UpdateCondition.fired();
             selectData.UserNotification[selectData.UserCallbacks]->FileDescriptor = tdSocket->Socket.SystemSocketID;
             selectData.UserNotification[selectData.UserCallbacks]->EventMask      = eventMask;
 #ifdef PRINT_SELECT
@@ -2637,7 +3082,7 @@ static int collectFDs(SelectData&     selectData,
             return(0);
          }
       }
-      else {
+      else if(tdSocket->Type == ExtSocketDescriptor::ESDT_SCTP) {
          int result = 0;
          if(eventMask & POLLIN) {
 #ifdef PRINT_SELECT
@@ -2679,12 +3124,13 @@ static int select_wrapper(int             n,
    FD_ZERO(&w);
    FD_ZERO(&e);
    int maxFD = 0;
-   int reverseMapping[ExtSocketDescriptorMaster::MaxSockets];
+   int reverseMapping[FD_SETSIZE];
    for(unsigned int i = 0;i < std::min((const unsigned int)n,(const unsigned int)FD_SETSIZE);i++) {
       if(SAFE_FD_ISSET(i,readfds) || SAFE_FD_ISSET(i,writefds) || SAFE_FD_ISSET(i,exceptfds)) {
          ExtSocketDescriptor* socket = ExtSocketDescriptorMaster::getSocket(i);
          if(socket != NULL) {
-            if(socket->Type == ExtSocketDescriptor::ESDT_System) {
+            if((socket->Type == ExtSocketDescriptor::ESDT_System) &&
+               (socket->Socket.SystemSocketID < (int)FD_SETSIZE)) {
                const int fd = socket->Socket.SystemSocketID;
                maxFD = std::max(maxFD,fd);
 
@@ -2742,7 +3188,7 @@ static int select_wrapper(int             n,
          SAFE_FD_ZERO(writefds);
       }
       else {
-         for(unsigned int i = 0;i < FD_SETSIZE;i++) {
+         for(unsigned int i = 0;i < std::min((const unsigned int)n,(const unsigned int)FD_SETSIZE);i++) {
             if(SAFE_FD_ISSET(i,writefds)) {
                ExtSocketDescriptor* socket = ExtSocketDescriptorMaster::getSocket(i);
                if((socket != NULL) &&
@@ -2802,16 +3248,7 @@ int ext_select(int             n,
 
    SCTPSocketMaster::MasterInstance.lock();
 
-   SelectData selectData;
-   selectData.Conditions    = 0;
-   selectData.UserCallbacks = 0;
-   selectData.GlobalCondition.setName("ext_select::GlobalCondition");
-   selectData.ReadCondition.setName("ext_select::ReadCondition");
-   selectData.WriteCondition.setName("ext_select::WriteCondition");
-   selectData.ExceptCondition.setName("ext_select::ExceptCondition");
-   selectData.ReadCondition.addParent(&selectData.GlobalCondition);
-   selectData.WriteCondition.addParent(&selectData.GlobalCondition);
-   selectData.ExceptCondition.addParent(&selectData.GlobalCondition);
+   SelectData& selectData = *getSelectData();
 
    int result = 0;
    for(int i = 0;i < std::min((const int)n,(const int)FD_SETSIZE);i++) {
@@ -2966,7 +3403,10 @@ int ext_select(int             n,
          changes++;
       }
 
-      delete selectData.UserNotification[i];
+      // Keep the notification for the next call.
+      selectData.UserNotification[i]->UpdateCondition.removeParent(&selectData.ReadCondition);
+      selectData.UserNotification[i]->UpdateCondition.removeParent(&selectData.WriteCondition);
+      selectData.UserNotification[i]->UpdateCondition.removeParent(&selectData.ExceptCondition);
    }
 
    SCTPSocketMaster::MasterInstance.unlock();
@@ -2975,78 +3415,354 @@ int ext_select(int             n,
 }
 
 
-// ###### An implementation of poll(), based on ext_select() ################
+// Internal structures for ext_poll(). They are kept per thread and reused
+// for subsequent calls, including the user socket notifications.
+struct PollEntry
+{
+   ExtSocketDescriptor*                      Descriptor;
+   cardinal                                  Conditions;
+   LeanCondition*                            ConditionArray[3];
+   int                                       SystemIndex;
+   SCTPSocketMaster::UserSocketNotification* UserNotification;
+};
+
+struct PollData
+{
+   Condition  UpdateCondition;
+   cardinal   Capacity;
+   PollEntry* EntryArray;
+   pollfd*    SystemFDArray;
+};
+
+static pthread_key_t  PollDataKey;
+static pthread_once_t PollDataKeyOnce = PTHREAD_ONCE_INIT;
+
+
+// ###### Free PollData structure at thread exit ############################
+static void freePollData(void* data)
+{
+   PollData* pollData = (PollData*)data;
+   for(cardinal i = 0;i < pollData->Capacity;i++) {
+      delete pollData->EntryArray[i].UserNotification;
+   }
+   delete [] pollData->EntryArray;
+   delete [] pollData->SystemFDArray;
+   delete pollData;
+}
+
+
+// ###### Create PollData key ###############################################
+static void createPollDataKey()
+{
+   pthread_key_create(&PollDataKey, freePollData);
+}
+
+
+// ###### Get PollData structure of calling thread ##########################
+static PollData* getPollData(const cardinal count)
+{
+   pthread_once(&PollDataKeyOnce, createPollDataKey);
+   PollData* pollData = (PollData*)pthread_getspecific(PollDataKey);
+   if(pollData == NULL) {
+      pollData = new PollData;
+      pollData->UpdateCondition.setName("ext_poll::UpdateCondition");
+      pollData->Capacity      = 0;
+      pollData->EntryArray    = NULL;
+      pollData->SystemFDArray = NULL;
+      pthread_setspecific(PollDataKey, pollData);
+   }
+   if(pollData->Capacity < count) {
+      PollEntry* entryArray = new PollEntry[count];
+      for(cardinal i = 0;i < count;i++) {
+         entryArray[i].UserNotification = (i < pollData->Capacity) ?
+                                             pollData->EntryArray[i].UserNotification : NULL;
+      }
+      delete [] pollData->EntryArray;
+      delete [] pollData->SystemFDArray;
+      pollData->EntryArray    = entryArray;
+      pollData->SystemFDArray = new pollfd[count];
+      pollData->Capacity      = count;
+   }
+   return(pollData);
+}
+
+
+// ###### Get poll() events of SCTP socket ##################################
+static short int getSCTPPollEvents(ExtSocketDescriptor* tdSocket)
+{
+   short int        revents     = 0;
+   SCTPAssociation* association = tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr;
+   SCTPSocket*      socket      = tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr;
+   if(association != NULL) {
+      if(association->isReady(UCT_Read)) {
+         revents |= POLLIN;
+      }
+      if(association->isReady(UCT_Write)) {
+         revents |= POLLOUT;
+      }
+      if(association->isClosed()) {
+         revents |= POLLHUP;
+         if(association->isAborted()) {
+            revents |= POLLERR;
+         }
+      }
+      else if(association->isReady(UCT_Except)) {
+         revents |= POLLERR;
+      }
+   }
+   else if(socket != NULL) {
+      if(socket->isReady(UCT_Read)) {
+         revents |= POLLIN;
+      }
+      // A connectionless socket is always writable.
+      if((!tdSocket->Socket.SCTPSocketDesc.ConnectionOriented) ||
+         (socket->isReady(UCT_Write))) {
+         revents |= POLLOUT;
+      }
+      if(socket->isReady(UCT_Except)) {
+         revents |= POLLERR;
+      }
+   }
+   return(revents);
+}
+
+
+// ###### Check state of all poll() entries #################################
+static int checkPollEntries(PollData*         pollData,
+                            struct pollfd*    fdlist,
+                            long unsigned int count,
+                            const cardinal    systemFDs)
+{
+   // ====== Check system FDs ===============================================
+   if(systemFDs > 0) {
+      if(::poll(pollData->SystemFDArray, systemFDs, 0) < 0) {
+         return(-errno);
+      }
+   }
+
+   // ====== Get results ====================================================
+   int result = 0;
+   for(unsigned int i = 0;i < count;i++) {
+      const PollEntry* entry = &pollData->EntryArray[i];
+      if(entry->Descriptor != NULL) {
+         if(entry->Descriptor->Type == ExtSocketDescriptor::ESDT_System) {
+            fdlist[i].revents = pollData->SystemFDArray[entry->SystemIndex].revents;
+         }
+         else {
+            fdlist[i].revents = getSCTPPollEvents(entry->Descriptor) &
+                                   (fdlist[i].events|POLLERR|POLLHUP);
+         }
+      }
+      if(fdlist[i].revents != 0) {
+         result++;
+      }
+   }
+   return(result);
+}
+
+
+// ###### poll() implementation #############################################
 int ext_poll(struct pollfd* fdlist, long unsigned int count, int time)
 {
-   // ====== Prepare timeout setting ========================================
-   timeval  timeout;
-   timeval* to;
-   if(time < 0)
-      to = NULL;
-   else {
-      to = &timeout;
-      timeout.tv_sec  = time / 1000;
-      timeout.tv_usec = (time % 1000) * 1000;
-   }
-
-   // ====== Prepare FD settings ============================================
-   int    fdcount = 0;
-   int    n       = 0;
-   fd_set readfdset;
-   fd_set writefdset;
-   fd_set exceptfdset;
-   FD_ZERO(&readfdset);
-   FD_ZERO(&writefdset);
-   FD_ZERO(&exceptfdset);
-   for(unsigned int i = 0; i < count; i++) {
-      if((fdlist[i].fd >= 0) && (fdlist[i].fd < (const int)FD_SETSIZE)) {
-         if(fdlist[i].events & POLLIN) {
-            FD_SET(fdlist[i].fd,&readfdset);
+   const bool running   = SCTPSocketMaster::MasterInstance.running();
+   PollData*  pollData  = getPollData(count);
+   cardinal   systemFDs = 0;
+   int        result    = 0;
+
+   SCTPSocketMaster::MasterInstance.lock();
+   pollData->UpdateCondition.fired();
+
+   // ====== Register listed descriptors ====================================
+   for(unsigned int i = 0;i < count;i++) {
+      PollEntry* entry = &pollData->EntryArray[i];
+      entry->Descriptor = NULL;
+      entry->Conditions = 0;
+      fdlist[i].revents = 0;
+      if(fdlist[i].fd < 0) {
+         continue;
+      }
+
+      ExtSocketDescriptor* tdSocket = ExtSocketDescriptorMaster::getSocket(fdlist[i].fd);
+      if((tdSocket != NULL) && (tdSocket->Type == ExtSocketDescriptor::ESDT_System)) {
+         entry->Descriptor  = tdSocket;
+         entry->SystemIndex = systemFDs;
+         pollData->SystemFDArray[systemFDs].fd      = tdSocket->Socket.SystemSocketID;
+         pollData->SystemFDArray[systemFDs].events  = fdlist[i].events;
+         pollData->SystemFDArray[systemFDs].revents = 0;
+         systemFDs++;
+
+         if(running) {
+            if(entry->UserNotification == NULL) {
+               entry->UserNotification = new SCTPSocketMaster::UserSocketNotification;
+            }
+            entry->UserNotification->FileDescriptor = tdSocket->Socket.SystemSocketID;
+            entry->UserNotification->EventMask      = fdlist[i].events & (POLLIN|POLLPRI|POLLOUT);
+            entry->UserNotification->UpdateCondition.fired();
+            entry->UserNotification->UpdateCondition.addParent(&pollData->UpdateCondition);
+            SCTPSocketMaster::MasterInstance.addUserSocketNotification(entry->UserNotification);
+         }
+      }
+      else if((tdSocket != NULL) && (tdSocket->Type == ExtSocketDescriptor::ESDT_SCTP) &&
+              ((tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr != NULL) ||
+               (tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr != NULL))) {
+         entry->Descriptor = tdSocket;
+
+         UpdateConditionType types[3];
+         cardinal            n = 0;
+         if(fdlist[i].events & (POLLIN|POLLPRI)) {
+            types[n++] = UCT_Read;
          }
          if(fdlist[i].events & POLLOUT) {
-            FD_SET(fdlist[i].fd,&writefdset);
+            types[n++] = UCT_Write;
+         }
+         types[n++] = UCT_Except;
+         for(cardinal j = 0;j < n;j++) {
+            LeanCondition* condition =
+               (tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr != NULL) ?
+                  tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr->getUpdateCondition(types[j]) :
+                  tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->getUpdateCondition(types[j]);
+            condition->addParent(&pollData->UpdateCondition);
+            entry->ConditionArray[entry->Conditions++] = condition;
          }
-         FD_SET(fdlist[i].fd,&exceptfdset);
-         n = std::max(n, fdlist[i].fd);
-         fdcount++;
       }
       else {
          fdlist[i].revents = POLLNVAL;
+         result++;
       }
    }
-   if(fdcount == 0) {
-      return(0);
+
+   // ====== Check states and wait for updates ==============================
+   if(result > 0) {
+      // There are invalid descriptors -> do not wait, but still check the
+      // other entries. The POLLNVAL entries are counted by checkPollEntries().
+      result = checkPollEntries(pollData, fdlist, count, systemFDs);
+   }
+   else {
+      if(!running) {
+         // SCTP is not available -> there are only system FDs.
+         SCTPSocketMaster::MasterInstance.unlock();
+         result = ::poll(pollData->SystemFDArray, systemFDs, time);
+         SCTPSocketMaster::MasterInstance.lock();
+         if(result >= 0) {
+            result = checkPollEntries(pollData, fdlist, count, 0);
+         }
+         else {
+            result = -errno;
+         }
+      }
+      else {
+         const card64 waitStart = getMicroTime();
+         for(;;) {
+            result = checkPollEntries(pollData, fdlist, count, systemFDs);
+            if((result != 0) || (time == 0)) {
+               break;
+            }
+
+            // sctplib removes a user callback after its first notification.
+            for(unsigned int i = 0;i < count;i++) {
+               PollEntry* entry = &pollData->EntryArray[i];
+               if((entry->Descriptor != NULL) &&
+                  (entry->Descriptor->Type == ExtSocketDescriptor::ESDT_System) &&
+                  (entry->UserNotification->Events != 0)) {
+                  SCTPSocketMaster::MasterInstance.addUserSocketNotification(entry->UserNotification);
+               }
+            }
+
+            SCTPSocketMaster::MasterInstance.unlock();
+            bool updated = true;
+            if(time < 0) {
+               pollData->UpdateCondition.wait();
+            }
+            else {
+               const card64 elapsed = getMicroTime() - waitStart;
+               const card64 limit   = (card64)time * 1000;
+               updated = (elapsed < limit) &&
+                         (pollData->UpdateCondition.timedWait(limit - elapsed));
+            }
+            SCTPSocketMaster::MasterInstance.lock();
+            if(!updated) {
+               result = checkPollEntries(pollData, fdlist, count, systemFDs);
+               break;
+            }
+         }
+      }
    }
+
+   // ====== Remove registrations ===========================================
    for(unsigned int i = 0;i < count;i++) {
-      fdlist[i].revents = 0;
+      PollEntry* entry = &pollData->EntryArray[i];
+      for(cardinal j = 0;j < entry->Conditions;j++) {
+         entry->ConditionArray[j]->removeParent(&pollData->UpdateCondition);
+      }
+      if((running) && (entry->Descriptor != NULL) &&
+         (entry->Descriptor->Type == ExtSocketDescriptor::ESDT_System)) {
+         SCTPSocketMaster::MasterInstance.deleteUserSocketNotification(entry->UserNotification);
+         entry->UserNotification->UpdateCondition.removeParent(&pollData->UpdateCondition);
+      }
    }
 
-   // ====== Do ext_select() ================================================
-   int result = ext_select(n + 1,&readfdset,&writefdset,&exceptfdset,to);
+   SCTPSocketMaster::MasterInstance.unlock();
+   errno_return(result);
+}
+
+
+// ###### epoll_create() implementation #####################################
+int ext_epoll_create(int size)
+{
+   if(size <= 0) {
+      errno_return(-EINVAL);
+   }
+
+   ExtSocketDescriptor tdSocket;
+   tdSocket.Type            = ExtSocketDescriptor::ESDT_Epoll;
+   tdSocket.Socket.EpollPtr = new ExtEpoll;
+   const int result = ExtSocketDescriptorMaster::setSocket(tdSocket);
    if(result < 0) {
-      return(result);
+      delete tdSocket.Socket.EpollPtr;
    }
+   errno_return(result);
+}
 
-   // ====== Set result flags ===============================================
-   result = 0;
-   for(unsigned int i = 0;i < count;i++) {
-      if((fdlist[i].fd >= 0) && (fdlist[i].fd < (const int)FD_SETSIZE)) {
-         fdlist[i].revents = 0;
-         if(SAFE_FD_ISSET(fdlist[i].fd,&readfdset) && (fdlist[i].events & POLLIN)) {
-            fdlist[i].revents |= POLLIN;
-         }
-         if(SAFE_FD_ISSET(fdlist[i].fd,&writefdset) && (fdlist[i].events & POLLOUT)) {
-            fdlist[i].revents |= POLLOUT;
-         }
-         if(SAFE_FD_ISSET(fdlist[i].fd,&exceptfdset)) {
-            fdlist[i].revents |= POLLERR;
-         }
-         if(fdlist[i].revents != 0) {
-            result++;
-         }
-      }
+
+// ###### epoll_ctl() implementation ########################################
+int ext_epoll_ctl(int epfd, int op, int fd, struct ext_epoll_event* event)
+{
+   ExtSocketDescriptor* tdEpoll  = ExtSocketDescriptorMaster::getSocket(epfd);
+   ExtSocketDescriptor* tdSocket = ExtSocketDescriptorMaster::getSocket(fd);
+   if((tdEpoll == NULL) || (tdSocket == NULL) ||
+      (tdSocket->Type == ExtSocketDescriptor::ESDT_Invalid)) {
+      errno_return(-EBADF);
    }
-   return(result);
+   if((tdEpoll->Type != ExtSocketDescriptor::ESDT_Epoll) || (epfd == fd)) {
+      errno_return(-EINVAL);
+   }
+   ExtEpoll* epoll = ExtEpoll::obtain(tdEpoll);
+   if(epoll == NULL) {
+      errno_return(-EBADF);
+   }
+   const int result = epoll->control(op, fd, tdSocket, event);
+   ExtEpoll::release(epoll);
+   errno_return(result);
+}
+
+
+// ###### epoll_wait() implementation #######################################
+int ext_epoll_wait(int epfd, struct ext_epoll_event* events, int maxevents, int timeout)
+{
+   ExtSocketDescriptor* tdEpoll = ExtSocketDescriptorMaster::getSocket(epfd);
+   if(tdEpoll == NULL) {
+      errno_return(-EBADF);
+   }
+   if(tdEpoll->Type != ExtSocketDescriptor::ESDT_Epoll) {
+      errno_return(-EINVAL);
+   }
+   ExtEpoll* epoll = ExtEpoll::obtain(tdEpoll);
+   if(epoll == NULL) {
+      errno_return(-EBADF);
+   }
+   const int result = epoll->wait(events, maxevents, timeout);
+   ExtEpoll::release(epoll);
+   errno_return(result);
 }
 
 
@@ -3078,8 +3794,10 @@ int sctp_peeloff(int              sockfd,
                   newExtSocketDescriptor.Socket.SCTPSocketDesc.SCTPSocketPtr      = tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr;
                   newExtSocketDescriptor.Socket.SCTPSocketDesc.SCTPAssociationPtr = association;
                   newExtSocketDescriptor.Socket.SCTPSocketDesc.ConnectionOriented = true;
+                  newExtSocketDescriptor.Socket.SCTPSocketDesc.SCTPSocketPtr->addDescriptorReference();
                   const int newFD = ExtSocketDescriptorMaster::setSocket(newExtSocketDescriptor);
                   if(newFD < 0) {
+                     newExtSocketDescriptor.Socket.SCTPSocketDesc.SCTPSocketPtr->removeDescriptorReference();
                      delete newExtSocketDescriptor.Socket.SCTPSocketDesc.SCTPAssociationPtr;
                      newExtSocketDescriptor.Socket.SCTPSocketDesc.SCTPAssociationPtr = NULL;
                   }
@@ -3419,6 +4137,29 @@ ssize_t sctp_recvmsg(int                     s,
 }
 
 
+// ###### sctp_eventfd() implementation #####################################
+int sctp_eventfd(int sd)
+{
+   ExtSocketDescriptor* tdSocket = ExtSocketDescriptorMaster::getSocket(sd);
+   if((tdSocket == NULL) || (tdSocket->Type != ExtSocketDescriptor::ESDT_SCTP)) {
+      errno_return(-EBADF);
+   }
+   int result = -EBADF;
+   SCTPSocketMaster::MasterInstance.lock();
+   if(tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr != NULL) {
+      result = tdSocket->Socket.SCTPSocketDesc.SCTPAssociationPtr->getEventFD();
+   }
+   else if(tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr != NULL) {
+      result = tdSocket->Socket.SCTPSocketDesc.SCTPSocketPtr->getEventFD();
+   }
+   SCTPSocketMaster::MasterInstance.unlock();
+   if(result == -1) {
+      result = -EMFILE;
+   }
+   errno_return(result);
+}
+
+
 #else
 
 